@@ -10,7 +10,7 @@
 enum {
     GRID_CELL_WIDTH = 7,
     GRID_CELL_HEIGHT = 15,
-    GRID_ROWS = 13,
+    GRID_ROWS = 29,
     GRID_COLS = 33,
     GRID_CELLS_COUNT = (GRID_ROWS * GRID_COLS),
     GRID_WIDTH = GRID_WIDTH_SPACED(GRID_CELL_WIDTH, GRID_COLS),
@@ -24,9 +24,18 @@ enum {
     LABEL_COL = 2,
     VALUE_COL = 11,
     VALUE_LEN = GRID_COLS - VALUE_COL - 2,
+
+    POOL_ROW = 9,
+    USAGE_ROW = 12,
+    USAGE_ROWS = 8,
+    USAGE_COLS = 2,
+    USAGE_COL_WIDTH = 15,
+
+    THREADS_ROW = 21,
+    THREADS_ROWS = 4,
+    THREADS_LEN = GRID_COLS - 2 * LABEL_COL,
 };
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -74,6 +83,66 @@ draw_cpu_usage(void)
     gui_wm_render_window_region(&window, r);
 }
 
+static void
+draw_mem_usage(void)
+{
+    static char buf[VALUE_LEN + 1];
+    const char *name;
+    size_t bytes;
+
+    snprintf(buf, sizeof(buf), "%u KB   ", gui_pool_get_used() >> 10);
+    draw_text_sm(VALUE_COL, POOL_ROW, buf);
+
+    snprintf(buf, sizeof(buf), "%u KB   ", gui_pool_get_free() >> 10);
+    draw_text_sm(VALUE_COL, POOL_ROW + 1, buf);
+
+    rect_st r = gui_rect_enclose(
+        gui_grid_cell_rect(&grid, 0, USAGE_ROW),
+        gui_grid_cell_rect(&grid, GRID_COLS - 1, USAGE_ROW + USAGE_ROWS - 1)
+    );
+    gui_surface_draw_rect(window.surface, r, window.bg_color);
+
+    for (size_t i = 0; i < USAGE_ROWS * USAGE_COLS; ++i) {
+        if (!gui_pool_get_usage(i, &name, &bytes)) {
+            break;
+        }
+
+        snprintf(buf, sizeof(buf), "%-10s%3uK", name, (bytes + 1023) >> 10);
+        draw_text_sm(LABEL_COL + (i % USAGE_COLS) * USAGE_COL_WIDTH,
+            USAGE_ROW + i / USAGE_COLS, buf);
+    }
+
+    r = gui_rect_enclose(r, gui_grid_cell_rect(&grid, VALUE_COL, POOL_ROW));
+    gui_wm_render_window_region(&window, r);
+}
+
+static void
+draw_threads(void)
+{
+    static char buf[THREADS_LEN + 1];
+    krn_thread_usage_st usage;
+
+    krn_thread_sample_usage();
+
+    rect_st r = gui_rect_enclose(
+        gui_grid_cell_rect(&grid, 0, THREADS_ROW + 1),
+        gui_grid_cell_rect(&grid, GRID_COLS - 1, THREADS_ROW + THREADS_ROWS)
+    );
+    gui_surface_draw_rect(window.surface, r, window.bg_color);
+
+    for (size_t i = 0; i < THREADS_ROWS; ++i) {
+        if (!krn_thread_get_usage(i, &usage)) {
+            break;
+        }
+
+        snprintf(buf, sizeof(buf), "%-8s%2u%5u%%%9u.%u s", usage.name, usage.priority,
+            usage.usage, usage.msecs / 1000, usage.msecs % 1000 / 100);
+        draw_text_sm(LABEL_COL, THREADS_ROW + 1 + i, buf);
+    }
+
+    gui_wm_render_window_region(&window, r);
+}
+
 static void
 draw_github_line(void)
 {
@@ -127,13 +196,16 @@ draw_info(void)
     draw_text_sm(LABEL_COL, line, "Mem:");
     draw_text_sm(VALUE_COL, line++, buf);
 
-    snprintf(buf, sizeof(buf), "%u KB", krn_system_get_used_mem() >> 10);
-    draw_text_sm(LABEL_COL, line, "Used:");
+    snprintf(buf, sizeof(buf), "%u KB", krn_system_get_kernel_size() >> 10);
+    draw_text_sm(LABEL_COL, line, "Kernel:");
     draw_text_sm(VALUE_COL, line++, buf);
 
-    snprintf(buf, sizeof(buf), "%u KB", krn_system_get_avail_mem() >> 10);
-    draw_text_sm(LABEL_COL, line, "Avail:");
-    draw_text_sm(VALUE_COL, line++, buf);
+    draw_text_sm(LABEL_COL, line++, "Windows:");
+    draw_text_sm(LABEL_COL, line++, "Avail:");
+    draw_mem_usage();
+
+    draw_text_sm(LABEL_COL, THREADS_ROW, "Threads:");
+    draw_threads();
 
     draw_github_line();
 
@@ -143,11 +215,6 @@ draw_info(void)
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.surface = &window_surface;
     window.title = "About";
     window.bg_color = COLOR_WINDOW;
@@ -173,9 +240,9 @@ on_timeout(void *unused _unsd)
 {
     if (window.visible) {
         draw_cpu_usage();
+        draw_mem_usage();
+        draw_threads();
     }
-
-    gui_timeout_add(1000, on_timeout, NULL);
 }
 
 static void
@@ -183,10 +250,16 @@ show_app(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "About",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         init_grid();
-        on_timeout(NULL);
+        gui_timeout_add_periodic(1000, on_timeout, NULL);
         initialized = 1;
     }
 
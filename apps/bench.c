@@ -0,0 +1,481 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: bench.c - Rendering benchmark app, run on the machine itself
+// --------------------------------------------------------------------------------------
+
+#include <gui.h>
+
+// Every test repeats a drawing primitive, doubling the number of iterations until
+// it runs long enough to be measured. Only one test runs per timeout, so the GUI
+// gets to present the results in between. Drawing happens on scratch surfaces,
+// except for the compositing, flushing and copying to VRAM, the latter of which
+// trashes the screen until it's flushed again at the end.
+
+enum {
+    GRID_CELL_WIDTH = 7,
+    GRID_CELL_HEIGHT = 15,
+    GRID_ROWS = 16,
+    GRID_COLS = 46,
+    GRID_WIDTH = GRID_WIDTH_SPACED(GRID_CELL_WIDTH, GRID_COLS),
+    GRID_HEIGHT = GRID_HEIGHT_SPACED(GRID_CELL_HEIGHT, GRID_ROWS),
+    GRID_X = 1,
+    GRID_Y = TITLE_BAR_HEIGHT,
+
+    SPACING = 10,
+    BUTTON_WIDTH = 60,
+    BUTTON_HEIGHT = 28,
+    BUTTON_X = (GRID_X + GRID_WIDTH + 1 - BUTTON_WIDTH) / 2,
+    BUTTON_Y = GRID_Y + GRID_HEIGHT + SPACING,
+
+    WINDOW_WIDTH = GRID_X + GRID_WIDTH + 1,
+    WINDOW_HEIGHT = BUTTON_Y + BUTTON_HEIGHT + SPACING,
+
+    LABEL_COL = 2,
+    TIME_COL = 22,
+    SPEED_COL = 33,
+    VALUE_LEN = GRID_COLS - LABEL_COL - 2,
+
+    INFO_ROW = 1,
+    HEADER_ROW = 3,
+    TESTS_ROW = 4,
+
+    SCRATCH_SIZE = 256,
+    SCRATCH_BYTES = SCRATCH_SIZE * SCRATCH_SIZE,
+
+    BENCH_MIN_USECS = 200000,
+    BENCH_MAX_ITERS = 1 << 20,
+    BENCH_STEP_DELAY = 10,
+
+    // A full-screen redraw should fit in a frame at 20 fps
+    FRAME_BUDGET_USECS = 50000,
+};
+
+typedef uint32_t (*bench_fn)(uint32_t iters);
+
+typedef struct {
+    const char *label;
+    const char *name;
+    bench_fn fn;
+} bench_test_st;
+
+static surface_st window_surface;
+static window_st window;
+
+static widget_st title_bar;
+static widget_st close_button;
+static widget_st run_button;
+static widget_st *widgets[3];
+
+static grid_st grid;
+
+static surface_st scratch_src;
+static surface_st scratch_dst;
+
+// Index of the next test to run, or -1 if no run is in progress
+static int bench_next = -1;
+static int bench_done = 0;
+
+static uint32_t bench_composite_nsecs = 0;
+static uint32_t bench_flush_nsecs = 0;
+
+static rect_st
+screen_rect(void)
+{
+    return gui_rect_make(0, 0, GUI_WIDTH, GUI_HEIGHT);
+}
+
+static uint32_t
+bench_fill_small(uint32_t iters)
+{
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_surface_draw_rect(&scratch_dst, gui_rect_make(i & 63, 0, 64, 64), i & 15);
+    }
+
+    return 64 * 64;
+}
+
+static uint32_t
+bench_fill_large(uint32_t iters)
+{
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_surface_draw_rect(&scratch_dst,
+            gui_rect_make(0, 0, SCRATCH_SIZE, SCRATCH_SIZE), i & 15);
+    }
+
+    return SCRATCH_BYTES;
+}
+
+static uint32_t
+bench_text(uint32_t iters)
+{
+    const char *text = "The quick brown fox jumps over ";
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_surface_draw_str(&scratch_dst, 0, (i & 15) * 16, font_8x16, text,
+            COLOR_TEXT_ACTIVE, COLOR_WINDOW);
+    }
+
+    return strlen(text) * 8 * 16;
+}
+
+static uint32_t
+bench_bitmap(uint32_t iters)
+{
+    bitmap_st *b = &bitmap_icon_about;
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_surface_draw_bitmap(&scratch_dst, (i & 7) * b->size.width,
+            ((i >> 3) & 7) * b->size.height, b, COLOR_TEXT_ACTIVE);
+    }
+
+    return b->size.width * b->size.height;
+}
+
+static uint32_t
+bench_blit(uint32_t iters)
+{
+    rect_st r = gui_rect_make(0, 0, SCRATCH_SIZE, SCRATCH_SIZE);
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_surface_copy(&scratch_dst, 0, 0, &scratch_src, r);
+    }
+
+    return SCRATCH_BYTES;
+}
+
+static uint32_t
+bench_composite(uint32_t iters)
+{
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_wm_render_desktop_region(gui_wm_container, NULL);
+    }
+
+    return gui_wm_container.width * gui_wm_container.height;
+}
+
+static uint32_t
+bench_flush(uint32_t iters)
+{
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_fb_mark_dirty(screen_rect());
+        gui_fb_flush();
+    }
+
+    // Planar mode writes 4 bits per pixel
+    return GUI_PLANAR_MODE ? GUI_WIDTH * GUI_HEIGHT / 2 : GUI_WIDTH * GUI_HEIGHT;
+}
+
+static uint32_t
+bench_memcpy_ram(uint32_t iters)
+{
+    for (uint32_t i = 0; i < iters; ++i) {
+        memcpy(scratch_dst.pixels, scratch_src.pixels, SCRATCH_BYTES);
+    }
+
+    return SCRATCH_BYTES;
+}
+
+static uint32_t
+bench_memcpy_vram(uint32_t iters)
+{
+    surface_st *vram = gui_fb_vram_surface;
+    uint32_t bytes = MIN(SCRATCH_BYTES, vram->pitch * vram->size.height);
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        memcpy(vram->pixels, scratch_src.pixels, bytes);
+    }
+
+    return bytes;
+}
+
+static const bench_test_st bench_tests[] = {
+    { "Fill 64x64", "fill_64x64", bench_fill_small },
+    { "Fill 256x256", "fill_256x256", bench_fill_large },
+    { "Text 31 chars", "text_8x16", bench_text },
+    { "Bitmap 24x27", "bitmap_24x27", bench_bitmap },
+    { "Blit 256x256", "blit_256x256", bench_blit },
+    { "Composite desktop", "composite", bench_composite },
+    { GUI_PLANAR_MODE ? "Flush planar" : "Flush chunky", "flush", bench_flush },
+    { "Memcpy to RAM", "memcpy_ram", bench_memcpy_ram },
+    { "Memcpy to VRAM", "memcpy_vram", bench_memcpy_vram },
+};
+
+#define TESTS_COUNT (int)(sizeof(bench_tests) / sizeof(bench_tests[0]))
+
+enum {
+    VERDICT_ROW = TESTS_ROW + TESTS_COUNT + 1,
+};
+
+static void
+draw_text(int col, int row, const char *text)
+{
+    rect_st r = gui_grid_cell_rect(&grid, col, row);
+    gui_surface_draw_str(window.surface, r.x, r.y, font_8x8,
+        text, COLOR_TEXT_ACTIVE, COLOR_WINDOW);
+}
+
+static void
+render_row(int row)
+{
+    rect_st r = gui_rect_enclose(
+        gui_grid_cell_rect(&grid, 0, row),
+        gui_grid_cell_rect(&grid, GRID_COLS - 1, row)
+    );
+
+    gui_wm_render_window_region(&window, r);
+}
+
+static void
+format_time(char *buf, size_t size, uint32_t nsecs)
+{
+    if (nsecs < 10000) {
+        snprintf(buf, size, "%u ns", nsecs);
+    } else if (nsecs < 10000000) {
+        snprintf(buf, size, "%u us", nsecs / 1000);
+    } else {
+        snprintf(buf, size, "%u ms", nsecs / 1000000);
+    }
+}
+
+static void
+draw_info(void)
+{
+    mboot_info_st *m = krn_core_mboot_info;
+    static char buf[VALUE_LEN + 1];
+
+    gui_surface_draw_rect(window.surface, gui_grid_rect(&grid), window.bg_color);
+
+    snprintf(buf, sizeof(buf), "%s %dx%d, CPU: %s",
+        GUI_PLANAR_MODE ? "Planar" : "Chunky", m->fb_width, m->fb_height,
+        krn_system_get_cpu_vendor());
+    draw_text(LABEL_COL, INFO_ROW, buf);
+
+    draw_text(LABEL_COL, HEADER_ROW, "Test");
+    draw_text(TIME_COL, HEADER_ROW, "Time/op");
+    draw_text(SPEED_COL, HEADER_ROW, "Speed");
+
+    for (int i = 0; i < TESTS_COUNT; ++i) {
+        draw_text(LABEL_COL, TESTS_ROW + i, bench_tests[i].label);
+    }
+
+    gui_wm_render_window_region(&window, gui_grid_rect(&grid));
+}
+
+// Run the test with enough iterations to be measurable. Returns the time
+// of a single iteration, in nanoseconds.
+static uint32_t
+run_test(const bench_test_st *t)
+{
+    static char buf[16];
+    uint32_t iters = 1;
+    uint32_t usecs;
+    uint32_t bytes;
+
+    for (;;) {
+        uint32_t start = (uint32_t)krn_timer_get_usecs();
+        bytes = t->fn(iters);
+        usecs = (uint32_t)krn_timer_get_usecs() - start;
+
+        if (usecs >= BENCH_MIN_USECS || iters >= BENCH_MAX_ITERS) {
+            break;
+        }
+
+        iters *= 2;
+    }
+
+    // Divided in an order which stays within 32 bits
+    uint32_t nsecs = usecs < 4000000 ? usecs * 1000 / iters : usecs / iters * 1000;
+    uint32_t kb_per_sec = bytes * iters / MAX(usecs / 1000, 1) * 1000 / 1024;
+
+    int row = TESTS_ROW + (t - bench_tests);
+
+    format_time(buf, sizeof(buf), nsecs);
+    draw_text(TIME_COL, row, buf);
+
+    snprintf(buf, sizeof(buf), "%u KB/s", kb_per_sec);
+    draw_text(SPEED_COL, row, buf);
+
+    krn_debug_printf("bench: test=%s iters=%u usecs=%u nsecs_per_op=%u kb_per_sec=%u\n",
+        t->name, iters, usecs, nsecs, kb_per_sec);
+
+    return nsecs;
+}
+
+static void
+free_scratch(void)
+{
+    krn_heap_free(scratch_src.pixels);
+    scratch_src.pixels = NULL;
+    scratch_dst.pixels = NULL;
+    bench_next = -1;
+}
+
+static void
+finish_run(void)
+{
+    static char buf[VALUE_LEN + 1];
+    uint32_t frame_usecs = (bench_composite_nsecs + bench_flush_nsecs) / 1000;
+    int ok = frame_usecs <= FRAME_BUDGET_USECS;
+
+    free_scratch();
+    bench_done = 1;
+
+    // The copy to VRAM trashed the screen, but the framebuffer still has its contents
+    gui_fb_mark_dirty(screen_rect());
+
+    snprintf(buf, sizeof(buf), "Full frame: %u ms, budget %u ms: %s",
+        frame_usecs / 1000, FRAME_BUDGET_USECS / 1000, ok ? "OK" : "too slow");
+    draw_text(LABEL_COL, VERDICT_ROW, buf);
+    render_row(VERDICT_ROW);
+
+    krn_debug_printf("bench: frame_usecs=%u budget_usecs=%u ok=%d\n",
+        frame_usecs, FRAME_BUDGET_USECS, ok);
+
+    if (ok) {
+        gui_status_set("Bench: full frame in %u ms, within the budget of %u ms",
+            frame_usecs / 1000, FRAME_BUDGET_USECS / 1000);
+    } else {
+        gui_status_set_alert("Bench: full frame in %u ms, over the budget of %u ms",
+            frame_usecs / 1000, FRAME_BUDGET_USECS / 1000);
+    }
+}
+
+static void
+on_timeout(void *unused _unsd)
+{
+    // The window's surface might be unloaded once it's closed
+    if (!window.visible) {
+        free_scratch();
+        gui_status_set("Bench: cancelled");
+        return;
+    }
+
+    const bench_test_st *t = &bench_tests[bench_next];
+    uint32_t nsecs = run_test(t);
+
+    if (t->fn == bench_composite) {
+        bench_composite_nsecs = nsecs;
+    } else if (t->fn == bench_flush) {
+        bench_flush_nsecs = nsecs;
+    }
+
+    render_row(TESTS_ROW + bench_next);
+
+    if (++bench_next < TESTS_COUNT) {
+        gui_timeout_add(BENCH_STEP_DELAY, on_timeout, NULL);
+    } else {
+        finish_run();
+    }
+}
+
+static void
+init_scratch(surface_st *surface, uint8_t *pixels)
+{
+    surface->size.width = SCRATCH_SIZE;
+    surface->size.height = SCRATCH_SIZE;
+    surface->pitch = SCRATCH_SIZE;
+    surface->pixels = pixels;
+}
+
+static void
+start_run(void)
+{
+    if (bench_next >= 0) {
+        return;
+    }
+
+    uint8_t *pixels = krn_heap_alloc(SCRATCH_BYTES * 2);
+
+    if (!pixels) {
+        gui_status_set_alert("Error: Not enough memory for %s", "Bench");
+        return;
+    }
+
+    init_scratch(&scratch_src, pixels);
+    init_scratch(&scratch_dst, pixels + SCRATCH_BYTES);
+
+    for (int i = 0; i < SCRATCH_BYTES; ++i) {
+        pixels[i] = i * 7 + (i >> 8);
+    }
+
+    mboot_info_st *m = krn_core_mboot_info;
+
+    krn_debug_printf("bench: mode=%s width=%u height=%u cpu=%s\n",
+        GUI_PLANAR_MODE ? "planar" : "chunky", m->fb_width, m->fb_height,
+        krn_system_get_cpu_vendor());
+
+    draw_info();
+
+    bench_next = 0;
+    gui_status_set("Bench: running, the screen will flicker");
+    gui_timeout_add(BENCH_STEP_DELAY, on_timeout, NULL);
+}
+
+static void
+on_run_button(widget_st *widget, event_st event, point_st pos)
+{
+    gui_button_on_pointer_up(widget, event, pos);
+
+    start_run();
+}
+
+static void
+init_window(void)
+{
+    window.surface = &window_surface;
+    window.title = "Bench";
+    window.bg_color = COLOR_WINDOW;
+    window.widgets = widgets;
+    window.widgets_capacity = sizeof(widgets) / sizeof(widgets[0]);
+
+    gui_window_init_frame(&window, &title_bar, &close_button);
+
+    run_button.type = WIDGET_TYPE_BUTTON;
+    run_button.rect = gui_rect_make(BUTTON_X, BUTTON_Y, BUTTON_WIDTH, BUTTON_HEIGHT);
+    run_button.label = "Run";
+    run_button.on_pointer_up = on_run_button;
+    gui_window_add_widget(&window, &run_button);
+}
+
+static void
+init_grid(void)
+{
+    grid.cell_width = GRID_CELL_WIDTH;
+    grid.cell_height = GRID_CELL_HEIGHT;
+    grid.cols = GRID_COLS;
+    grid.rows = GRID_ROWS;
+    grid.x = GRID_X;
+    grid.y = GRID_Y;
+}
+
+static void
+show_app(void)
+{
+    static int initialized = 0;
+
+    if (gui_pool_load_surface(&window_surface, "Bench",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
+    if (!initialized) {
+        init_window();
+        init_grid();
+        draw_info();
+        initialized = 1;
+    }
+
+    gui_wm_add_window(&window);
+
+    if (!bench_done) {
+        start_run();
+    }
+}
+
+app_st app_bench = {
+    .icon = &bitmap_icon_bench,
+    .show = show_app,
+};
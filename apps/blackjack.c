@@ -48,7 +48,6 @@ static const char *rank_str[] = {
 
 static const char *suit_str[] = { "\x03", "\x04", "\x05", "\x06" };
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -359,11 +358,6 @@ on_active_change(window_st *window)
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.surface = &window_surface;
     window.title = "Blackjack";
     window.bg_color = COLOR_WINDOW;
@@ -406,6 +400,12 @@ show_app(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "Blackjack",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         init_buttons();
@@ -29,7 +29,6 @@ enum {
     DISPLAY_WIDTH = GRID_WIDTH,
 };
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -208,11 +207,6 @@ on_button_press(widget_st *widget, event_st event _unsd, point_st pos _unsd)
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.surface = &window_surface;
     window.title = "Calculator";
     window.bg_color = COLOR_BORDER;
@@ -257,6 +251,12 @@ show_app(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "Calculator",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         init_buttons();
@@ -36,7 +36,6 @@ static widget_st next_button;
 static widget_st day_buttons[GRID_CELLS_COUNT];
 static widget_st *widgets[GRID_CELLS_COUNT + 4];
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -208,11 +207,6 @@ on_next_button(widget_st *widget _unsd, event_st event,
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.surface = &window_surface;
     window.title = "Calendar";
     window.bg_color = COLOR_WINDOW;
@@ -290,6 +284,12 @@ show_app(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "Calendar",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         init_buttons();
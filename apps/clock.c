@@ -21,7 +21,6 @@ enum {
     WINDOW_HEIGHT = GRID_Y + GRID_HEIGHT + 1,
 };
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -81,28 +80,20 @@ draw_time(void)
 }
 
 static void
-on_timeout(void *unused _unsd)
+on_time_change(window_st *w _unsd, event_st event _unsd)
 {
-    if (window.visible) {
-        draw_time();
-    }
-
-    gui_timeout_add(200, on_timeout, NULL);
+    draw_time();
 }
 
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.surface = &window_surface;
     window.title = "Clock";
     window.bg_color = COLOR_WINDOW;
     window.widgets = widgets;
     window.widgets_capacity = sizeof(widgets) / sizeof(widgets[0]);
+    window.on_time_change = on_time_change;
 
     gui_window_init_frame(&window, &title_bar, &close_button);
 }
@@ -123,14 +114,20 @@ show_app(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "Clock",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         init_grid();
-        draw_time();
-        on_timeout(NULL);
         initialized = 1;
     }
 
+    draw_time();
+
     gui_wm_add_window(&window);
 }
 
@@ -26,7 +26,6 @@ enum {
     MINE_COUNT = 18,
 };
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -57,6 +56,27 @@ enum {
 static uint8_t cell_state[GRID_COLS][GRID_ROWS];
 static uint8_t cell_type[GRID_COLS][GRID_ROWS];
 
+static const krn_note_st sound_click[] = {
+    { .hz = 1500, .msecs = 10 },
+};
+
+static const krn_note_st sound_flag[] = {
+    { .hz = 1000, .msecs = 20 },
+};
+
+static const krn_note_st sound_explosion[] = {
+    { .hz = 150, .msecs = 60 },
+    { .hz = 110, .msecs = 60 },
+    { .hz = 80, .msecs = 250 },
+};
+
+static const krn_note_st sound_win[] = {
+    { .hz = 523, .msecs = 80 },
+    { .hz = 659, .msecs = 80 },
+    { .hz = 784, .msecs = 80 },
+    { .hz = 1047, .msecs = 200 },
+};
+
 static size_t
 count_cells_by_state(uint8_t state)
 {
@@ -306,6 +326,16 @@ on_cell_pointer_up(widget_st *widget, event_st event _unsd, point_st pos _unsd)
     }
 
     reveal_cell(col, row);
+
+    int state = get_game_state();
+
+    if (state == GAME_STATE_LOST) {
+        KRN_SPEAKER_QUEUE(sound_explosion);
+    } else if (state == GAME_STATE_WON) {
+        KRN_SPEAKER_QUEUE(sound_win);
+    } else {
+        KRN_SPEAKER_QUEUE(sound_click);
+    }
 }
 
 static void
@@ -322,9 +352,11 @@ on_cell_pointer_alt(widget_st *widget, event_st event _unsd, point_st pos _unsd)
     if (cell_state[col][row] == CELL_STATE_HIDDEN) {
         update_cell(col, row, cell_type[col][row], CELL_STATE_FLAGGED);
         update_status();
+        KRN_SPEAKER_QUEUE(sound_flag);
     } else if (cell_state[col][row] == CELL_STATE_FLAGGED) {
         update_cell(col, row, cell_type[col][row], CELL_STATE_HIDDEN);
         update_status();
+        KRN_SPEAKER_QUEUE(sound_flag);
     }
 }
 
@@ -339,11 +371,6 @@ on_active_change(window_st *window)
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.surface = &window_surface;
     window.title = "Mines";
     window.bg_color = COLOR_BORDER;
@@ -385,6 +412,12 @@ show_app(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "Mines",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         init_grid();
@@ -0,0 +1,304 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: monitor.c - Performance monitor app, with history graphs
+// --------------------------------------------------------------------------------------
+
+#include <gui.h>
+
+// Once opened, the app keeps sampling the counters of the kernel and the GUI in
+// the background, so the history is there when the window is shown again. While
+// visible, every sample scrolls the graphs by one column and only draws the new
+// one, unless the scale of a graph changes and it has to be redrawn entirely.
+
+enum {
+    HISTORY_LEN = 240,
+    SAMPLE_INTERVAL = 500,
+
+    SPACING = 8,
+    LABEL_HEIGHT = 12,
+    GRAPH_WIDTH = HISTORY_LEN,
+    GRAPH_HEIGHT = 40,
+    GRAPH_X = SPACING + 1,
+    PANEL_HEIGHT = LABEL_HEIGHT + GRAPH_HEIGHT + 2 + SPACING,
+    PANELS_Y = TITLE_BAR_HEIGHT + SPACING,
+
+    WINDOW_WIDTH = GRAPH_X + GRAPH_WIDTH + 1 + SPACING,
+
+    GRAPH_COLOR_BG = COLOR_BLACK,
+    GRAPH_COLOR_FG = 0x0A,
+    GRAPH_COLOR_GRID = COLOR_WINDOW_DARKER,
+
+    // Keeps the multiplication when scaling the samples within 32 bits
+    SCALE_MAX = 100000000,
+};
+
+typedef struct {
+    const char *label;
+    uint32_t fixed_scale;
+    uint32_t scale;
+    uint32_t history[HISTORY_LEN];
+} graph_st;
+
+enum {
+    GRAPH_BUSY = 0,
+    GRAPH_EVENTS = 1,
+    GRAPH_FRAMES = 2,
+    GRAPH_FLUSHED = 3,
+    GRAPH_DIRTY = 4,
+    GRAPH_LATE = 5,
+    GRAPHS_COUNT = 6,
+
+    WINDOW_HEIGHT = PANELS_Y + GRAPHS_COUNT * PANEL_HEIGHT,
+};
+
+static graph_st graphs[GRAPHS_COUNT] = {
+    [GRAPH_BUSY] = { .label = "Busy %", .fixed_scale = 100 },
+    [GRAPH_EVENTS] = { .label = "Events/s" },
+    [GRAPH_FRAMES] = { .label = "Frames/s" },
+    [GRAPH_FLUSHED] = { .label = "Flush KB/s" },
+    [GRAPH_DIRTY] = { .label = "Dirty %", .fixed_scale = 100 },
+    [GRAPH_LATE] = { .label = "Late ms" },
+};
+
+// Position of the next sample in the histories, which is also the oldest one
+static size_t history_head = 0;
+
+// Values of the counters at the last sample
+static struct {
+    uint64_t usecs;
+    uint64_t idle_usecs;
+    uint32_t events;
+    uint32_t frames;
+    uint32_t flushed_bytes;
+    uint32_t dirty_pixels;
+} last;
+
+static surface_st window_surface;
+static window_st window;
+
+static widget_st title_bar;
+static widget_st close_button;
+static widget_st *widgets[2];
+
+static rect_st
+graph_rect(int idx)
+{
+    return gui_rect_make(GRAPH_X, PANELS_Y + idx * PANEL_HEIGHT + LABEL_HEIGHT + 1,
+        GRAPH_WIDTH, GRAPH_HEIGHT);
+}
+
+static rect_st
+panels_rect(void)
+{
+    return gui_rect_make(0, PANELS_Y, WINDOW_WIDTH, GRAPHS_COUNT * PANEL_HEIGHT);
+}
+
+static uint32_t
+graph_sample(graph_st *graph, int age)
+{
+    return graph->history[(history_head + HISTORY_LEN - 1 - age) % HISTORY_LEN];
+}
+
+// Unless the scale is fixed, round the largest sample in the history up to 1, 2
+// or 5 times a power of 10. Returns 1 if the scale changed.
+static int
+graph_update_scale(graph_st *graph)
+{
+    uint32_t max = 0;
+    uint32_t scale = 10;
+
+    if (graph->fixed_scale) {
+        scale = graph->fixed_scale;
+    } else {
+        for (int i = 0; i < HISTORY_LEN; ++i) {
+            max = MAX(max, graph->history[i]);
+        }
+
+        for (int i = 0; scale < max && scale < SCALE_MAX; ++i) {
+            scale = (i % 3 == 1) ? scale / 2 * 5 : scale * 2;
+        }
+    }
+
+    if (scale == graph->scale) {
+        return 0;
+    }
+
+    graph->scale = scale;
+
+    return 1;
+}
+
+static void
+draw_column(int idx, int col, uint32_t value)
+{
+    graph_st *graph = &graphs[idx];
+    rect_st r = graph_rect(idx);
+    int x = r.x + col;
+    int h = value >= graph->scale ? GRAPH_HEIGHT : value * GRAPH_HEIGHT / graph->scale;
+
+    gui_surface_draw_v_seg(window.surface, x, r.y, GRAPH_HEIGHT - h, GRAPH_COLOR_BG);
+    gui_surface_draw_v_seg(window.surface, x, r.y + GRAPH_HEIGHT - h, h, GRAPH_COLOR_FG);
+
+    // Dotted line at half of the scale
+    if (h < GRAPH_HEIGHT / 2 && (col & 1)) {
+        gui_surface_draw_h_seg(window.surface, x, r.y + GRAPH_HEIGHT / 2, 1,
+            GRAPH_COLOR_GRID);
+    }
+}
+
+static void
+draw_label(int idx)
+{
+    static char buf[GRAPH_WIDTH / 8 + 1];
+    graph_st *graph = &graphs[idx];
+    rect_st r = graph_rect(idx);
+
+    snprintf(buf, sizeof(buf), "%-11s%7u / %-7u", graph->label, graph_sample(graph, 0),
+        graph->scale);
+    gui_surface_draw_str(window.surface, r.x, r.y - LABEL_HEIGHT, font_8x8, buf,
+        COLOR_TEXT_ACTIVE, window.bg_color);
+}
+
+static void
+draw_graph(int idx)
+{
+    for (int col = 0; col < GRAPH_WIDTH; ++col) {
+        draw_column(idx, col, graph_sample(&graphs[idx], GRAPH_WIDTH - 1 - col));
+    }
+}
+
+static void
+draw_all(void)
+{
+    gui_surface_draw_rect(window.surface, panels_rect(), window.bg_color);
+
+    for (int i = 0; i < GRAPHS_COUNT; ++i) {
+        rect_st r = graph_rect(i);
+
+        r = gui_rect_make(r.x - 1, r.y - 1, r.width + 2, r.height + 2);
+        gui_surface_draw_border(window.surface, r, COLOR_BORDER);
+
+        (void)graph_update_scale(&graphs[i]);
+        draw_label(i);
+        draw_graph(i);
+    }
+
+    gui_wm_render_window_region(&window, panels_rect());
+}
+
+// Scroll the graphs by one column and draw the newest sample
+static void
+draw_update(void)
+{
+    for (int i = 0; i < GRAPHS_COUNT; ++i) {
+        if (graph_update_scale(&graphs[i])) {
+            draw_graph(i);
+        } else {
+            gui_surface_scroll(window.surface, graph_rect(i), -1);
+            draw_column(i, GRAPH_WIDTH - 1, graph_sample(&graphs[i], 0));
+        }
+
+        draw_label(i);
+    }
+
+    gui_wm_render_window_region(&window, panels_rect());
+}
+
+static void
+take_sample(void)
+{
+    uint64_t usecs = krn_timer_get_usecs();
+    uint64_t idle_usecs = krn_timer_get_idle_usecs();
+    uint32_t elapsed = MAX((uint32_t)(usecs - last.usecs), 1);
+    uint32_t idle = (uint32_t)(idle_usecs - last.idle_usecs);
+    uint32_t msecs = MAX(elapsed / 1000, 1);
+    uint32_t frames = gui_fb_frames - last.frames;
+    uint32_t values[GRAPHS_COUNT];
+
+    values[GRAPH_BUSY] = idle >= elapsed ? 0
+        : MIN((elapsed - idle) / MAX(elapsed / 100, 1), 100u);
+    values[GRAPH_EVENTS] = (gui_events_handled - last.events) * 1000 / msecs;
+    values[GRAPH_FRAMES] = frames * 1000 / msecs;
+    values[GRAPH_FLUSHED] = ((gui_fb_flushed_bytes - last.flushed_bytes) >> 10)
+        * 1000 / msecs;
+    values[GRAPH_DIRTY] = frames ? (gui_fb_dirty_pixels - last.dirty_pixels) / frames
+        * 100 / (GUI_WIDTH * GUI_HEIGHT) : 0;
+    values[GRAPH_LATE] = gui_timeout_take_late_max();
+
+    for (int i = 0; i < GRAPHS_COUNT; ++i) {
+        graphs[i].history[history_head] = values[i];
+    }
+
+    history_head = (history_head + 1) % HISTORY_LEN;
+
+    last.usecs = usecs;
+    last.idle_usecs = idle_usecs;
+    last.events = gui_events_handled;
+    last.frames = gui_fb_frames;
+    last.flushed_bytes = gui_fb_flushed_bytes;
+    last.dirty_pixels = gui_fb_dirty_pixels;
+}
+
+static void
+on_timeout(void *unused _unsd)
+{
+    take_sample();
+
+    if (window.visible) {
+        draw_update();
+    }
+}
+
+static void
+init_window(void)
+{
+    window.surface = &window_surface;
+    window.title = "Monitor";
+    window.bg_color = COLOR_WINDOW;
+    window.widgets = widgets;
+    window.widgets_capacity = sizeof(widgets) / sizeof(widgets[0]);
+
+    gui_window_init_frame(&window, &title_bar, &close_button);
+}
+
+static void
+init_graphs(void)
+{
+    // Start counting from now, rather than from boot
+    take_sample();
+    history_head = 0;
+
+    for (int i = 0; i < GRAPHS_COUNT; ++i) {
+        memset(graphs[i].history, 0, sizeof(graphs[i].history));
+    }
+}
+
+static void
+show_app(void)
+{
+    static int initialized = 0;
+
+    if (gui_pool_load_surface(&window_surface, "Monitor",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
+    if (!initialized) {
+        init_window();
+        init_graphs();
+        gui_timeout_add_periodic(SAMPLE_INTERVAL, on_timeout, NULL);
+        initialized = 1;
+    }
+
+    draw_all();
+
+    gui_wm_add_window(&window);
+}
+
+app_st app_monitor = {
+    .icon = &bitmap_icon_monitor,
+    .show = show_app,
+};
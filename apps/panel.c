@@ -21,6 +21,8 @@ static app_st *apps[] = {
     &app_tetris,
     &app_pairs,
     &app_blackjack,
+    &app_bench,
+    &app_monitor,
 };
 
 #define APPS_COUNT (sizeof(apps) / sizeof(apps[0]))
@@ -42,7 +44,6 @@ enum {
 
 static int current_page = 0;
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -113,11 +114,6 @@ on_next_pointer_up(widget_st *widget, event_st event, point_st pos)
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.rect.x = GUI_WIDTH - WINDOW_WIDTH;
     window.rect.y = 0;
     window.rect.width = WINDOW_WIDTH;
@@ -180,6 +176,12 @@ show_panel(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "Panel",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         init_app_buttons();
@@ -38,7 +38,6 @@ enum {
     WIDGETS_COUNT = PATTERN_COUNT + COLOR_COUNT + COLOR_COUNT + 2,
 };
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -163,11 +162,6 @@ on_color2_button_press(widget_st *widget, event_st event _unsd, point_st pos _un
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.surface = &window_surface;
     window.title = "Patterns";
     window.bg_color = COLOR_BLACK;
@@ -254,6 +248,12 @@ show_app(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "Patterns",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         select_active_buttons();
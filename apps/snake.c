@@ -24,7 +24,6 @@ enum {
     TIMEOUT_DURATION = 120,
 };
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -62,6 +61,17 @@ static int score = 0;
 static int best_score = 0;
 static uint64_t timeout_id = 0;
 
+static const krn_note_st sound_eat[] = {
+    { .hz = 880, .msecs = 30 },
+    { .hz = 1175, .msecs = 40 },
+};
+
+static const krn_note_st sound_crash[] = {
+    { .hz = 330, .msecs = 80 },
+    { .hz = 220, .msecs = 80 },
+    { .hz = 147, .msecs = 200 },
+};
+
 static void on_timeout(void *);
 
 static int
@@ -98,7 +108,7 @@ resume_game(void)
         return;
     }
 
-    timeout_id = gui_timeout_add(TIMEOUT_DURATION, on_timeout, NULL);
+    timeout_id = gui_timeout_add_periodic(TIMEOUT_DURATION, on_timeout, NULL);
 
     update_status();
 }
@@ -201,15 +211,16 @@ static void
 on_timeout(void *unused _unsd)
 {
     if (!window.visible) {
+        gui_timeout_remove(timeout_id);
+        timeout_id = 0;
         return;
     }
 
-    timeout_id = gui_timeout_add(TIMEOUT_DURATION, on_timeout, NULL);
-
     coords_st next_head = move_head(*body.head);
 
     if (next_head.x < 0 || next_head.x >= GRID_COLS ||
         next_head.y < 0 || next_head.y >= GRID_ROWS) {
+        KRN_SPEAKER_QUEUE(sound_crash);
         restart_game();
         return;
     }
@@ -217,11 +228,13 @@ on_timeout(void *unused _unsd)
     uint8_t next_block = cells[next_head.x][next_head.y];
 
     if (next_block != CELL_FRUIT && next_block != CELL_FLOOR) {
+        KRN_SPEAKER_QUEUE(sound_crash);
         restart_game();
         return;
     }
 
     if (next_block == CELL_FRUIT) {
+        KRN_SPEAKER_QUEUE(sound_eat);
         body.grow += 2;
         score += 5;
         update_status();
@@ -269,11 +282,6 @@ on_active_change(window_st *window)
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.surface = &window_surface;
     window.title = "Snake";
     window.bg_color = COLOR_WINDOW;
@@ -301,6 +309,12 @@ show_app(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "Snake",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         init_grid();
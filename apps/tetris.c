@@ -21,9 +21,11 @@ enum {
     WINDOW_HEIGHT = GRID_Y + GRID_HEIGHT + 1,
 
     DROP_INTERVAL = 300,
+    SOFT_DROP_INTERVAL = 50,
+    REPEAT_DELAY = 150,
+    REPEAT_RATE = 40,
 };
 
-static uint8_t window_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
@@ -52,9 +54,26 @@ static int game_over;
 static size_t score;
 static size_t best_score;
 static uint64_t timeout_id;
+static uint32_t drop_interval;
 
 static void on_timeout(void *);
 
+static const krn_note_st sound_lock[] = {
+    { .hz = 220, .msecs = 20 },
+};
+
+static const krn_note_st sound_clear[] = {
+    { .hz = 523, .msecs = 60 },
+    { .hz = 659, .msecs = 60 },
+    { .hz = 784, .msecs = 100 },
+};
+
+static const krn_note_st sound_game_over[] = {
+    { .hz = 392, .msecs = 150 },
+    { .hz = 330, .msecs = 150 },
+    { .hz = 262, .msecs = 300 },
+};
+
 static int
 is_game_paused(void)
 {
@@ -93,11 +112,24 @@ resume_game(void)
         return;
     }
 
-    timeout_id = gui_timeout_add(DROP_INTERVAL, on_timeout, NULL);
+    drop_interval = DROP_INTERVAL;
+    timeout_id = gui_timeout_add_periodic(drop_interval, on_timeout, NULL);
 
     update_status();
 }
 
+static void
+set_drop_interval(uint32_t msecs)
+{
+    if (msecs == drop_interval) {
+        return;
+    }
+
+    gui_timeout_remove(timeout_id);
+    drop_interval = msecs;
+    timeout_id = gui_timeout_add_periodic(drop_interval, on_timeout, NULL);
+}
+
 static void
 update_score(int ds)
 {
@@ -216,9 +248,11 @@ is_row_full(int row)
     return 1;
 }
 
-static void
+static int
 clear_rows(void)
 {
+    int cleared = 0;
+
     for (int row = GRID_ROWS - 1; row >= 0; --row) {
         if (!is_row_full(row)) {
             continue;
@@ -241,8 +275,11 @@ clear_rows(void)
         }
 
         update_score(20);
+        ++cleared;
         ++row;
     }
+
+    return cleared;
 }
 
 static void
@@ -255,6 +292,7 @@ spawn_piece(void)
 
     if (!is_piece_valid(cur_piece, cur_row, cur_col, cur_rot)) {
         game_over = 1;
+        KRN_SPEAKER_QUEUE(sound_game_over);
 
         if (score > best_score) {
             best_score = score;
@@ -289,18 +327,31 @@ static void
 on_timeout(void *unused _unsd)
 {
     if (!window.visible) {
+        gui_timeout_remove(timeout_id);
+        timeout_id = 0;
         return;
     }
 
-    timeout_id = gui_timeout_add(DROP_INTERVAL, on_timeout, NULL);
-
     if (game_over) {
         return;
     }
 
+    // The soft drop lasts for as long as the down arrow is held, which is polled
+    // on every tick, so it doesn't depend on the repeat rate of the keyboard
+    if (drop_interval == SOFT_DROP_INTERVAL && !krn_keyboard_is_pressed(KEY_DOWN)) {
+        set_drop_interval(DROP_INTERVAL);
+        return;
+    }
+
     if (!move_current_piece(1, 0, 0)) {
         lock_current_piece();
-        clear_rows();
+
+        if (clear_rows() > 0) {
+            KRN_SPEAKER_QUEUE(sound_clear);
+        } else {
+            KRN_SPEAKER_QUEUE(sound_lock);
+        }
+
         spawn_piece();
     }
 }
@@ -308,6 +359,13 @@ on_timeout(void *unused _unsd)
 static void
 on_keyboard(window_st *w _unsd, event_st event)
 {
+    // Only sideways moves repeat when the key is held down
+    if ((event.key_flags & KEY_FLAG_REPEAT) &&
+        event.key_code != KEY_LEFT && event.key_code != KEY_RIGHT) {
+
+        return;
+    }
+
     if (game_over) {
         restart_game();
         return;
@@ -332,6 +390,7 @@ on_keyboard(window_st *w _unsd, event_st event)
         move_current_piece(0, 1, 0);
     } else if (event.key_code == KEY_DOWN) {
         move_current_piece(1, 0, 0);
+        set_drop_interval(SOFT_DROP_INTERVAL);
     } else if (event.key_code == KEY_UP) {
         move_current_piece(0, 0, 1);
     } else if (event.key_char == ' ') {
@@ -345,8 +404,10 @@ static void
 on_active_change(window_st *win)
 {
     if (win->active) {
+        krn_keyboard_set_repeat(REPEAT_DELAY, REPEAT_RATE);
         update_status();
     } else {
+        krn_keyboard_set_repeat(0, 0);
         pause_game();
     }
 }
@@ -354,11 +415,6 @@ on_active_change(window_st *win)
 static void
 init_window(void)
 {
-    window_surface.size.width = WINDOW_WIDTH;
-    window_surface.size.height = WINDOW_HEIGHT;
-    window_surface.pitch = WINDOW_WIDTH;
-    window_surface.pixels = window_pixels;
-
     window.surface = &window_surface;
     window.title = "Tetris";
     window.bg_color = COLOR_WINDOW;
@@ -386,6 +442,12 @@ show_app(void)
 {
     static int initialized = 0;
 
+    if (gui_pool_load_surface(&window_surface, "Tetris",
+        WINDOW_WIDTH, WINDOW_HEIGHT) != 0) {
+
+        return;
+    }
+
     if (!initialized) {
         init_window();
         init_grid();
@@ -34,6 +34,30 @@ bitmap_st bitmap_icon_about = {
         "\x56\x56\x56\x56\x56\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
 };
 
+bitmap_st bitmap_icon_bench = {
+    .size = { .width = 24, .height = 17 },
+    .foreground = 0x00,
+    .alpha = 0x56,
+    .pixels = (uint8_t *)
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x00\x00\x00\x00\x00\x56\x56\x00\x00\x00\x00\x00\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x00\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56\x00\x00\x00\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x00\x00\x56\x56\x56\x56\x56\x00\x00\x56\x56\x56\x56\x56\x00\x00\x56\x56\x56\x56" \
+        "\x56\x56\x56\x00\x00\x56\x56\x56\x56\x56\x56\x00\x00\x56\x56\x00\x56\x56\x56\x00\x00\x56\x56\x56" \
+        "\x56\x56\x00\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x00\x00\x56\x56\x00\x00\x00\x56\x56" \
+        "\x56\x56\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x00\x56\x56\x56\x56\x00\x00\x56\x56" \
+        "\x56\x56\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x00\x56\x56\x56\x56\x56\x00\x00\x56\x56" \
+        "\x56\x56\x00\x00\x56\x56\x56\x56\x56\x56\x56\x00\x00\x00\x00\x56\x56\x56\x56\x56\x00\x00\x56\x56" \
+        "\x56\x00\x00\x56\x56\x00\x00\x56\x56\x56\x00\x00\x00\x00\x56\x56\x56\x00\x00\x56\x56\x00\x00\x56" \
+        "\x56\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x56" \
+        "\x56\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+};
+
 bitmap_st bitmap_icon_blackjack = {
     .size = { .width = 26, .height = 32 },
     .foreground = 0x00,
@@ -284,6 +308,30 @@ bitmap_st bitmap_icon_mines = {
         "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
 };
 
+bitmap_st bitmap_icon_monitor = {
+    .size = { .width = 24, .height = 17 },
+    .foreground = 0x00,
+    .alpha = 0x56,
+    .pixels = (uint8_t *)
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x56\x56" \
+        "\x56\x56\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x56\x56" \
+        "\x56\x56\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x56\x56\x56\x00\x56\x56" \
+        "\x56\x56\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x00\x56\x56\x56\x00\x56\x56" \
+        "\x56\x56\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x56\x56\x56\x00\x56\x00\x56\x56\x00\x56\x56" \
+        "\x56\x56\x00\x56\x56\x56\x56\x56\x56\x56\x56\x00\x56\x00\x56\x00\x56\x56\x00\x56\x56\x00\x56\x56" \
+        "\x56\x56\x00\x56\x56\x00\x56\x56\x56\x56\x00\x56\x56\x56\x00\x00\x56\x56\x56\x00\x56\x00\x56\x56" \
+        "\x56\x56\x00\x56\x00\x56\x00\x56\x56\x00\x56\x56\x56\x56\x56\x00\x56\x56\x56\x56\x00\x00\x56\x56" \
+        "\x56\x56\x00\x00\x56\x56\x56\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x56\x56" \
+        "\x56\x56\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x56\x56" \
+        "\x56\x56\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x00\x00\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x00\x00\x00\x00\x00\x00\x00\x00\x56\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+        "\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56\x56" \
+};
+
 bitmap_st bitmap_icon_pairs = {
     .size = { .width = 26, .height = 26 },
     .foreground = 0x00,
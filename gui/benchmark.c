@@ -0,0 +1,278 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: benchmark.c - Scripted benchmark, enabled with "benchmark" on the kernel cmdline
+// --------------------------------------------------------------------------------------
+
+// Every phase feeds the GUI with events, one step at a time, each step
+// being handled and presented before the next one. The results are printed
+// to the debug port as "key=value" lines, and the CPU is halted at the end.
+
+#include <gui.h>
+
+enum {
+    // Layout of the app buttons, see apps/panel.c
+    ICON_MARGIN = 8,
+    ICON_STRIDE = 56,
+    ICON_SIZE = 48,
+
+    DRAG_STEPS = 40,
+    DRAG_DISTANCE = 8,
+
+    TETRIS_ROUNDS = 10,
+};
+
+typedef int (*benchmark_step_fn)(int step);
+
+static int benchmark_enabled = 0;
+static int benchmark_phase = -1;
+static int benchmark_step = 0;
+static uint64_t benchmark_started_at = 0;
+
+static struct {
+    uint64_t started_at;
+    uint32_t events;
+    uint32_t dropped;
+    uint32_t io_count;
+} benchmark_current;
+
+static point_st benchmark_drag_pos;
+
+static void
+gui_benchmark_push(event_st event)
+{
+    if (krn_event_push(event) == 0) {
+        benchmark_current.events++;
+    } else {
+        benchmark_current.dropped++;
+    }
+}
+
+static void
+gui_benchmark_push_pointer(uint8_t type, int x, int y)
+{
+    event_st event = {
+        .type = type,
+        .pointer_x = x,
+        .pointer_y = y,
+    };
+
+    gui_benchmark_push(event);
+}
+
+static void
+gui_benchmark_push_key(uint8_t code, uint8_t ch)
+{
+    event_st event = {
+        .type = EVENT_KEY_DOWN,
+        .key_code = code,
+        .key_char = ch,
+    };
+
+    gui_benchmark_push(event);
+
+    event.type = EVENT_KEY_UP;
+    gui_benchmark_push(event);
+}
+
+static void
+gui_benchmark_click(int x, int y)
+{
+    gui_benchmark_push_pointer(EVENT_POINTER_DOWN, x, y);
+    gui_benchmark_push_pointer(EVENT_POINTER_UP, x, y);
+}
+
+static void
+gui_benchmark_click_app(int idx)
+{
+    gui_benchmark_click(GUI_WIDTH - PANEL_WIDTH / 2,
+        ICON_MARGIN + idx * ICON_STRIDE + ICON_SIZE / 2);
+}
+
+static int
+gui_benchmark_open_apps(int step)
+{
+    // About, Clock, Calendar, Calc and Mines, leaving one of the window slots
+    // of the window manager free for Tetris
+    static const int apps[] = { 0, 1, 2, 3, 9 };
+
+    if (step >= (int)(sizeof(apps) / sizeof(apps[0]))) {
+        return 0;
+    }
+
+    gui_benchmark_click_app(apps[step]);
+    return 1;
+}
+
+// Drag the top window by its title bar around a square
+static int
+gui_benchmark_drag_window(int step)
+{
+    point_st *pos = &benchmark_drag_pos;
+    window_st *w = gui_wm_top_window();
+
+    if (step == 0 && w) {
+        pos->x = w->rect.x + w->rect.width / 2;
+        pos->y = w->rect.y + TITLE_BAR_HEIGHT / 2;
+        gui_benchmark_push_pointer(EVENT_POINTER_DOWN, pos->x, pos->y);
+    } else if (step > 0 && step <= DRAG_STEPS) {
+        int side = (step - 1) / (DRAG_STEPS / 4);
+
+        pos->x += side == 0 ? DRAG_DISTANCE : side == 2 ? -DRAG_DISTANCE : 0;
+        pos->y += side == 1 ? DRAG_DISTANCE : side == 3 ? -DRAG_DISTANCE : 0;
+        gui_benchmark_push_pointer(EVENT_POINTER_MOVE, pos->x, pos->y);
+    } else if (step == DRAG_STEPS + 1) {
+        gui_benchmark_push_pointer(EVENT_POINTER_UP, pos->x, pos->y);
+    } else {
+        return 0;
+    }
+
+    return 1;
+}
+
+static void gui_benchmark_abort(const char *reason);
+
+// Open Tetris from the second page of the panel and play a few pieces
+static int
+gui_benchmark_play_tetris(int step)
+{
+    static const uint8_t moves[] = {
+        KEY_LEFT, KEY_LEFT, KEY_UP, KEY_RIGHT, KEY_RIGHT, KEY_RIGHT,
+        KEY_DOWN, KEY_DOWN, KEY_SPACE,
+    };
+    int moves_count = sizeof(moves) / sizeof(moves[0]);
+
+    if (step == 0) {
+        gui_benchmark_click(GUI_WIDTH - PANEL_WIDTH / 4, GUI_HEIGHT - STATUS_HEIGHT / 2);
+    } else if (step == 1) {
+        gui_benchmark_click_app(0);
+    } else if (step - 2 < TETRIS_ROUNDS * moves_count) {
+        window_st *w = gui_wm_top_window();
+
+        // Otherwise the keys would go to another window, and the phase would
+        // measure nothing
+        if (step == 2 && (!w || strcmp(w->title, "Tetris") != 0)) {
+            gui_benchmark_abort("tetris_not_open");
+        }
+
+        uint8_t code = moves[(step - 2) % moves_count];
+        gui_benchmark_push_key(code, code == KEY_SPACE ? ' ' : 0);
+    } else {
+        return 0;
+    }
+
+    return 1;
+}
+
+static const struct {
+    const char *name;
+    benchmark_step_fn step;
+} benchmark_phases[] = {
+    { "open_apps", gui_benchmark_open_apps },
+    { "drag_window", gui_benchmark_drag_window },
+    { "play_tetris", gui_benchmark_play_tetris },
+};
+
+#define PHASES_COUNT (int)(sizeof(benchmark_phases) / sizeof(benchmark_phases[0]))
+
+static void
+gui_benchmark_begin_phase(void)
+{
+    benchmark_step = 0;
+    benchmark_current.started_at = krn_timer_get_usecs();
+    benchmark_current.events = 0;
+    benchmark_current.dropped = 0;
+    benchmark_current.io_count = cpu_io_count;
+}
+
+static void
+gui_benchmark_end_phase(void)
+{
+    uint32_t usecs = krn_timer_get_usecs() - benchmark_current.started_at;
+
+    krn_debug_printf("benchmark phase=%s steps=%u events=%u dropped=%u usecs=%u io=%u\n",
+        benchmark_phases[benchmark_phase].name, benchmark_step - 1,
+        benchmark_current.events, benchmark_current.dropped, usecs,
+        cpu_io_count - benchmark_current.io_count);
+}
+
+static void
+gui_benchmark_halt(void)
+{
+    krn_debug_printf("benchmark halted\n");
+    krn_serial_flush();
+
+    cpu_cli();
+
+    while (1) {
+        cpu_hlt();
+    }
+}
+
+static void
+gui_benchmark_abort(const char *reason)
+{
+    krn_debug_printf("benchmark aborted phase=%s reason=%s\n",
+        benchmark_phases[benchmark_phase].name, reason);
+
+    gui_benchmark_halt();
+}
+
+static void
+gui_benchmark_finish(void)
+{
+    uint32_t usecs = krn_timer_get_usecs() - benchmark_started_at;
+
+    krn_debug_printf("benchmark end usecs=%u\n", usecs);
+
+    krn_event_dump_stats();
+    gui_timeout_dump_stats();
+    gui_latency_dump();
+    gui_vga_dump_stats();
+    krn_heap_dump_stats();
+    krn_serial_dump_stats();
+
+    gui_benchmark_halt();
+}
+
+// Called when all events were handled and presented. Pushes the events of the next
+// step and returns 1, or returns 0 if the benchmark is disabled.
+int
+gui_benchmark_on_idle(void)
+{
+    if (!benchmark_enabled) {
+        return 0;
+    }
+
+    if (benchmark_phase < 0) {
+        benchmark_started_at = krn_timer_get_usecs();
+
+        krn_debug_printf("benchmark begin clock=%s boot_usecs=%u\n",
+            krn_system_has_tsc() ? "tsc" : "pit", (uint32_t)benchmark_started_at);
+    }
+
+    while (benchmark_phase < PHASES_COUNT) {
+        if (benchmark_phase >= 0) {
+            if (benchmark_phases[benchmark_phase].step(benchmark_step++)) {
+                return 1;
+            }
+
+            gui_benchmark_end_phase();
+        }
+
+        if (++benchmark_phase < PHASES_COUNT) {
+            gui_benchmark_begin_phase();
+        }
+    }
+
+    gui_benchmark_finish();
+
+    return 0;
+}
+
+void
+gui_benchmark_init(void)
+{
+    benchmark_enabled = krn_system_has_boot_arg("benchmark");
+}
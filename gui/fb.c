@@ -17,6 +17,11 @@ static surface_st gui_fb_surface = { 0 };
 
 static rect_st dirty_rect = { 0 };
 
+// Totals since boot, sampled by the monitor app
+uint32_t gui_fb_frames = 0;
+uint32_t gui_fb_dirty_pixels = 0;
+uint32_t gui_fb_flushed_bytes = 0;
+
 void
 gui_fb_draw_start(void)
 {
@@ -32,6 +37,8 @@ gui_fb_mark_dirty(rect_st rect)
 {
     static rect_st screen_rect = { .width = GUI_WIDTH, .height = GUI_HEIGHT };
     dirty_rect = gui_rect_clip(gui_rect_enclose(dirty_rect, rect), screen_rect);
+    gui_latency_on_damage();
+    gui_overlay_on_damage(rect);
 }
 
 void
@@ -70,6 +77,55 @@ gui_fb_draw_surface(int dst_x, int dst_y, surface_st *src_sf, rect_st src_rect)
     gui_fb_mark_dirty(gui_rect_make(dst_x, dst_y, src_rect.width, src_rect.height));
 }
 
+// Draw text directly to the framebuffer. This must only be used
+// for regions which are not covered by any window.
+void
+gui_fb_draw_char(int x, int y, font_st *font, uint8_t ch, uint8_t fg, uint8_t bg)
+{
+#if GUI_PLANAR_MODE
+    gui_planar_draw_char(x, y, font, ch, fg, bg);
+#else
+    gui_surface_draw_char(&gui_fb_surface, x, y, font, ch, fg, bg);
+#endif
+
+    gui_fb_mark_dirty(gui_rect_make(x, y, font->size.width, font->size.height));
+}
+
+void
+gui_fb_draw_str(int x, int y, font_st *font, const char *s, uint8_t fg, uint8_t bg)
+{
+#if GUI_PLANAR_MODE
+    gui_planar_draw_str(x, y, font, s, fg, bg);
+#else
+    gui_surface_draw_str(&gui_fb_surface, x, y, font, s, fg, bg);
+#endif
+
+    gui_fb_mark_dirty(gui_rect_make(x, y, strlen(s) * font->size.width,
+        font->size.height));
+}
+
+// Draw without marking anything dirty, for the debug overlay, which makes sure
+// that its drawings are copied to the screen, see gui/overlay.c
+void
+gui_fb_draw_overlay_rect(rect_st rect, uint8_t color)
+{
+#if GUI_PLANAR_MODE
+    gui_planar_draw_rect(rect, color);
+#else
+    gui_surface_draw_rect(&gui_fb_surface, rect, color);
+#endif
+}
+
+void
+gui_fb_draw_overlay_str(int x, int y, const char *s, uint8_t fg, uint8_t bg)
+{
+#if GUI_PLANAR_MODE
+    gui_planar_draw_str(x, y, font_8x8, s, fg, bg);
+#else
+    gui_surface_draw_str(&gui_fb_surface, x, y, font_8x8, s, fg, bg);
+#endif
+}
+
 void
 gui_fb_draw_outline(rect_st rect)
 {
@@ -80,6 +136,16 @@ gui_fb_draw_outline(rect_st rect)
 #endif
 }
 
+static void
+gui_fb_copy_to_vram(rect_st rect)
+{
+#if GUI_PLANAR_MODE
+    gui_planar_flush(rect);
+#else
+    gui_surface_copy(gui_fb_vram_surface, rect.x, rect.y, &gui_fb_surface, rect);
+#endif
+}
+
 void
 gui_fb_flush(void)
 {
@@ -92,14 +158,30 @@ gui_fb_flush(void)
     rect_st rect = dirty_rect;
     dirty_rect = (rect_st) { 0 };
 
+    // The overlay draws inside of the flushed region, except for its readout
+    rect_st readout = gui_overlay_draw(rect);
+
+    gui_fb_frames++;
+    gui_fb_dirty_pixels += rect.width * rect.height;
+
 #if GUI_PLANAR_MODE
-    gui_planar_flush(rect);
+    // Every plane is copied in whole bytes of 8 pixels
+    gui_fb_flushed_bytes += ((rect.x + rect.width + 7) / 8 - rect.x / 8)
+        * rect.height * 4;
 #else
-    gui_surface_copy(gui_fb_vram_surface, rect.x, rect.y, &gui_fb_surface, rect);
+    gui_fb_flushed_bytes += rect.width * rect.height;
 #endif
 
+    gui_fb_copy_to_vram(rect);
+
+    if (!gui_rect_is_empty(readout)) {
+        gui_fb_copy_to_vram(readout);
+    }
+
     gui_pointer_draw();
     gui_drag_draw_outline();
+
+    gui_latency_on_present();
 }
 
 void
@@ -0,0 +1,186 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: latency.c - Latency histograms of input events
+// --------------------------------------------------------------------------------------
+
+#include <gui.h>
+
+// Every input event is timed from the interrupt that pushed it, through
+// the handler and the damage it caused, to the flush presenting that damage
+
+enum {
+    LATENCY_BUCKETS = 17,
+    LATENCY_PENDING_MAX = 16,
+    LATENCY_DEBUG = 0,
+    LATENCY_REPORT_INTERVAL = 10000,
+};
+
+enum {
+    LATENCY_QUEUE = 0,
+    LATENCY_HANDLE = 1,
+    LATENCY_PRESENT = 2,
+    LATENCY_TOTAL = 3,
+    LATENCY_KINDS = 4,
+};
+
+typedef struct {
+    uint32_t seq;
+    uint32_t pushed_at;
+    uint32_t handled_at;
+} latency_pending_st;
+
+typedef struct {
+    uint32_t count;
+    uint32_t max;
+    uint32_t buckets[LATENCY_BUCKETS];
+} latency_hist_st;
+
+static const char *latency_names[LATENCY_KINDS] = {
+    "queue", "handle", "present", "total",
+};
+
+static latency_hist_st latency_hists[LATENCY_KINDS];
+
+// Event being handled right now
+static latency_pending_st latency_current;
+static uint32_t latency_started_at = 0;
+static int latency_tracking = 0;
+static int latency_damaged = 0;
+
+// Handled events whose damage wasn't flushed yet
+static latency_pending_st latency_pending[LATENCY_PENDING_MAX];
+static size_t latency_pending_count = 0;
+static uint32_t latency_presented_seq = 0;
+
+static int
+gui_latency_is_input(event_st *event)
+{
+    return event->type == EVENT_POINTER_MOVE || event->type == EVENT_POINTER_DOWN ||
+        event->type == EVENT_POINTER_UP || event->type == EVENT_POINTER_ALT ||
+        event->type == EVENT_KEY_DOWN || event->type == EVENT_KEY_UP;
+}
+
+// Bucket 0 is below 16us, every next one covers twice as much time
+static int
+gui_latency_bucket(uint32_t usecs)
+{
+    int bucket = 0;
+
+    for (usecs >>= 4; usecs && bucket < LATENCY_BUCKETS - 1; usecs >>= 1) {
+        bucket++;
+    }
+
+    return bucket;
+}
+
+static void
+gui_latency_record(int kind, uint32_t usecs)
+{
+    latency_hist_st *h = &latency_hists[kind];
+
+    h->count++;
+    h->max = MAX(h->max, usecs);
+    h->buckets[gui_latency_bucket(usecs)]++;
+}
+
+static uint32_t
+gui_latency_now(void)
+{
+    return (uint32_t)krn_timer_get_usecs();
+}
+
+void
+gui_latency_begin(event_st *event)
+{
+    latency_tracking = gui_latency_is_input(event);
+
+    if (!latency_tracking) {
+        return;
+    }
+
+    latency_started_at = gui_latency_now();
+    latency_current.seq = event->seq;
+    latency_current.pushed_at = event->usecs;
+    latency_damaged = 0;
+
+    gui_latency_record(LATENCY_QUEUE, latency_started_at - event->usecs);
+}
+
+void
+gui_latency_end(void)
+{
+    if (!latency_tracking) {
+        return;
+    }
+
+    uint32_t now = gui_latency_now();
+
+    gui_latency_record(LATENCY_HANDLE, now - latency_started_at);
+    latency_current.handled_at = now;
+    latency_tracking = 0;
+
+    if (latency_damaged && latency_pending_count < LATENCY_PENDING_MAX) {
+        latency_pending[latency_pending_count++] = latency_current;
+    }
+}
+
+// Called when the framebuffer is damaged, to attribute the damage to the current event
+void
+gui_latency_on_damage(void)
+{
+    latency_damaged = latency_tracking;
+}
+
+// Called when the damage is flushed to the screen
+void
+gui_latency_on_present(void)
+{
+    uint32_t now = gui_latency_now();
+
+    for (size_t i = 0; i < latency_pending_count; ++i) {
+        gui_latency_record(LATENCY_PRESENT, now - latency_pending[i].handled_at);
+        gui_latency_record(LATENCY_TOTAL, now - latency_pending[i].pushed_at);
+        latency_presented_seq = latency_pending[i].seq;
+    }
+
+    latency_pending_count = 0;
+}
+
+void
+gui_latency_dump(void)
+{
+    static char line[LATENCY_BUCKETS * 11 + 1];
+
+    krn_debug_printf("latency: last presented event: #%u, "
+        "buckets from <16us, doubling up to >=%ums\n",
+        latency_presented_seq, (16 << (LATENCY_BUCKETS - 2)) / 1000);
+
+    for (int kind = 0; kind < LATENCY_KINDS; ++kind) {
+        latency_hist_st *h = &latency_hists[kind];
+        size_t len = 0;
+
+        for (int i = 0; i < LATENCY_BUCKETS; ++i) {
+            len += snprintf(line + len, sizeof(line) - len, " %u", h->buckets[i]);
+        }
+
+        krn_debug_printf("latency: %-7s n=%u max=%uus:%s\n", latency_names[kind],
+            h->count, h->max, line);
+    }
+}
+
+static void
+gui_latency_on_report_timeout(timeout_payload payload _unsd)
+{
+    gui_latency_dump();
+}
+
+void
+gui_latency_init(void)
+{
+    if (LATENCY_DEBUG) {
+        gui_timeout_add_periodic(LATENCY_REPORT_INTERVAL, gui_latency_on_report_timeout,
+            NULL);
+    }
+}
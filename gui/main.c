@@ -7,79 +7,121 @@
 
 #include <gui.h>
 
+enum {
+    FRAME_ARENA_PAGES = 16,
+    EVENT_BATCH_SIZE = 16,
+};
+
+// Temporary memory for drawing, reset before handling every event
+krn_arena_st gui_frame_arena;
+
+// Total since boot, sampled by the monitor app
+uint32_t gui_events_handled = 0;
+
+static window_st *pressed_window = NULL;
+
+static void
+gui_dispatch_event(event_st event)
+{
+    if (event.type == EVENT_TIMER_TICK) {
+        gui_timeout_on_tick(event);
+    } else if (event.type == EVENT_TIME_CHANGE) {
+        gui_wm_on_time_change(event);
+    } else if (event.type == EVENT_POINTER_DOWN) {
+        gui_pointer_move(event.pointer_x, event.pointer_y);
+
+        window_st *w = gui_wm_find_window(event.pointer_x, event.pointer_y);
+
+        if (w) {
+            pressed_window = w;
+            gui_wm_raise_window(w);
+            gui_window_on_pointer_down(w, event);
+        }
+    } else if (event.type == EVENT_POINTER_MOVE) {
+        gui_pointer_move(event.pointer_x, event.pointer_y);
+
+        if (pressed_window) {
+            gui_window_on_pointer_move(pressed_window, event);
+        }
+    } else if (event.type == EVENT_POINTER_UP) {
+        gui_pointer_move(event.pointer_x, event.pointer_y);
+
+        if (pressed_window) {
+            gui_window_on_pointer_up(pressed_window, event);
+        }
+
+        pressed_window = NULL;
+    } else if (event.type == EVENT_POINTER_ALT) {
+        gui_pointer_move(event.pointer_x, event.pointer_y);
+
+        window_st *w = gui_wm_find_window(event.pointer_x, event.pointer_y);
+
+        if (w && !pressed_window) {
+            gui_window_on_pointer_alt(w, event);
+        }
+    } else if (event.type == EVENT_KEY_DOWN) {
+        window_st *w = gui_wm_top_window();
+
+        if (w && w->on_key_down) {
+            w->on_key_down(w, event);
+        }
+    } else if (event.type == EVENT_KEY_UP) {
+        window_st *w = gui_wm_top_window();
+
+        if (w && w->on_key_up) {
+            w->on_key_up(w, event);
+        }
+    } else if (event.type == EVENT_HOTKEY && event.key_code == HOTKEY_OVERLAY) {
+        gui_overlay_toggle();
+    }
+}
+
+static void
+gui_handle_event(event_st event)
+{
+    krn_arena_reset(&gui_frame_arena);
+    gui_events_handled++;
+
+    gui_latency_begin(&event);
+    gui_dispatch_event(event);
+    gui_latency_end();
+}
+
 void
 gui_main(void)
 {
-    event_st event;
-    window_st *pressed_window = NULL;
+    static event_st events[EVENT_BATCH_SIZE];
+    int more;
+
+    krn_arena_init(&gui_frame_arena, FRAME_ARENA_PAGES);
 
     gui_vga_init();
     gui_fb_init();
     gui_pointer_init();
     gui_wm_init();
+    gui_latency_init();
+    gui_benchmark_init();
     gui_fb_flush();
 
     while (1) {
-        if (krn_event_count() == 0) {
-            krn_timer_is_cpu_idle = 1;
-            cpu_hlt();
-            krn_timer_is_cpu_idle = 0;
+        size_t count = krn_event_pop_many(events, EVENT_BATCH_SIZE, &more);
+
+        if (count == 0 && gui_benchmark_on_idle()) {
             continue;
         }
 
-        if (krn_event_pop(&event) != 0) {
+        if (count == 0) {
+            gui_timeout_set_deadline();
+            krn_event_wait();
             continue;
         }
 
-        if (event.type == EVENT_TIMER_TICK) {
-            gui_timeout_on_tick(event);
-        } else if (event.type == EVENT_POINTER_DOWN) {
-            gui_pointer_move(event.pointer_x, event.pointer_y);
-
-            window_st *w = gui_wm_find_window(event.pointer_x, event.pointer_y);
-
-            if (w) {
-                pressed_window = w;
-                gui_wm_raise_window(w);
-                gui_window_on_pointer_down(w, event);
-            }
-        } else if (event.type == EVENT_POINTER_MOVE) {
-            gui_pointer_move(event.pointer_x, event.pointer_y);
-
-            if (pressed_window) {
-                gui_window_on_pointer_move(pressed_window, event);
-            }
-        } else if (event.type == EVENT_POINTER_UP) {
-            gui_pointer_move(event.pointer_x, event.pointer_y);
-
-            if (pressed_window) {
-                gui_window_on_pointer_up(pressed_window, event);
-            }
-
-            pressed_window = NULL;
-        } else if (event.type == EVENT_POINTER_ALT) {
-            gui_pointer_move(event.pointer_x, event.pointer_y);
-
-            window_st *w = gui_wm_find_window(event.pointer_x, event.pointer_y);
-
-            if (w && !pressed_window) {
-                gui_window_on_pointer_alt(w, event);
-            }
-        } else if (event.type == EVENT_KEY_DOWN) {
-            window_st *w = gui_wm_top_window();
-
-            if (w && w->on_key_down) {
-                w->on_key_down(w, event);
-            }
-        } else if (event.type == EVENT_KEY_UP) {
-            window_st *w = gui_wm_top_window();
-
-            if (w && w->on_key_up) {
-                w->on_key_up(w, event);
-            }
+        for (size_t i = 0; i < count; ++i) {
+            gui_handle_event(events[i]);
         }
 
-        if (krn_event_count() == 0) {
+        // Present once the queue has been drained
+        if (!more) {
             gui_fb_flush();
         }
     }
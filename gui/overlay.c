@@ -0,0 +1,188 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: overlay.c - Debug overlay of the repainted regions, toggled with Ctrl+Alt+O
+// --------------------------------------------------------------------------------------
+
+#include <gui.h>
+
+// While enabled, every flush outlines the rects marked dirty since the previous
+// one, colored by how many of them cover it, so that overdraw stands out. The
+// outlines are drawn into the framebuffer along with the frame, and erased by
+// re-rendering their region a moment later. A readout in the corner shows the
+// numbers of the last frame: composites, dirty rects, highest overdraw and the
+// size of the flushed region.
+
+enum {
+    OVERLAY_RECTS_MAX = 64,
+    OVERLAY_FLASH_MSECS = 300,
+    OVERLAY_READOUT_LEN = 48,
+    OVERLAY_READOUT_X = 2,
+    OVERLAY_READOUT_Y = GUI_HEIGHT - STATUS_HEIGHT - 10,
+
+    // Bright green, yellow and red, for regions painted once, twice and more
+    OVERLAY_COLOR_ONCE = 0x0A,
+    OVERLAY_COLOR_TWICE = 0x0E,
+    OVERLAY_COLOR_MORE = 0x0C,
+    OVERLAY_COLOR_READOUT = COLOR_WHITE,
+};
+
+static int overlay_enabled = 0;
+
+// Rects marked dirty in the current frame
+static rect_st overlay_rects[OVERLAY_RECTS_MAX];
+static size_t overlay_rects_count = 0;
+static uint32_t overlay_rects_total = 0;
+static uint32_t overlay_composites = 0;
+
+// Region of the outlines still on the screen
+static rect_st overlay_flashed = { 0 };
+static int overlay_flash_pending = 0;
+
+// Set while the overlay repaints the screen itself, which isn't recorded
+static int overlay_restoring = 0;
+
+static char overlay_readout[OVERLAY_READOUT_LEN + 1];
+
+static rect_st
+gui_overlay_readout_rect(void)
+{
+    return gui_rect_make(OVERLAY_READOUT_X, OVERLAY_READOUT_Y,
+        OVERLAY_READOUT_LEN * 8, 8);
+}
+
+// Count the rects of the frame overlapping the one at idx, including itself
+static int
+gui_overlay_count_overlaps(size_t idx)
+{
+    int ret = 0;
+
+    for (size_t i = 0; i < overlay_rects_count; ++i) {
+        if (!gui_rect_is_empty(gui_rect_clip(overlay_rects[idx], overlay_rects[i]))) {
+            ret++;
+        }
+    }
+
+    return ret;
+}
+
+static void
+gui_overlay_draw_outline(rect_st r, uint8_t color)
+{
+    gui_fb_draw_overlay_rect(gui_rect_make(r.x, r.y, r.width, 1), color);
+    gui_fb_draw_overlay_rect(gui_rect_make(r.x, r.y + r.height - 1, r.width, 1), color);
+    gui_fb_draw_overlay_rect(gui_rect_make(r.x, r.y, 1, r.height), color);
+    gui_fb_draw_overlay_rect(gui_rect_make(r.x + r.width - 1, r.y, 1, r.height), color);
+}
+
+// Re-render the region of the outlines, which marks it dirty again
+static void
+gui_overlay_restore(rect_st rect)
+{
+    overlay_restoring = 1;
+    gui_wm_render_screen_region(rect);
+    overlay_restoring = 0;
+}
+
+static void
+gui_overlay_on_flash_timeout(timeout_payload payload _unsd)
+{
+    overlay_flash_pending = 0;
+
+    if (!gui_rect_is_empty(overlay_flashed)) {
+        gui_overlay_restore(overlay_flashed);
+        overlay_flashed = (rect_st) { 0 };
+    }
+}
+
+// Called by gui_fb_mark_dirty
+void
+gui_overlay_on_damage(rect_st rect)
+{
+    static rect_st screen_rect = { .width = GUI_WIDTH, .height = GUI_HEIGHT };
+
+    // The outlines are drawn without clipping
+    rect = gui_rect_clip(rect, screen_rect);
+
+    if (!overlay_enabled || overlay_restoring || gui_rect_is_empty(rect)) {
+        return;
+    }
+
+    overlay_rects_total++;
+
+    if (overlay_rects_count < OVERLAY_RECTS_MAX) {
+        overlay_rects[overlay_rects_count++] = rect;
+    }
+}
+
+// Called by gui_wm_render_desktop_region
+void
+gui_overlay_on_composite(void)
+{
+    if (overlay_enabled && !overlay_restoring) {
+        overlay_composites++;
+    }
+}
+
+// Called by gui_fb_flush before copying the flushed region to the screen.
+// Returns the region of the readout, which also needs to be copied.
+rect_st
+gui_overlay_draw(rect_st flushed)
+{
+    if (!overlay_enabled) {
+        return (rect_st) { 0 };
+    }
+
+    int overdraw = 0;
+
+    for (size_t i = 0; i < overlay_rects_count; ++i) {
+        int count = gui_overlay_count_overlaps(i);
+
+        gui_overlay_draw_outline(overlay_rects[i], count == 1 ? OVERLAY_COLOR_ONCE
+            : count == 2 ? OVERLAY_COLOR_TWICE : OVERLAY_COLOR_MORE);
+
+        overlay_flashed = gui_rect_enclose(overlay_flashed, overlay_rects[i]);
+        overdraw = MAX(overdraw, count);
+    }
+
+    // Frames which only erase the outlines keep the readout of the last one
+    if (overlay_rects_total > 0) {
+        snprintf(overlay_readout, sizeof(overlay_readout),
+            "comp %-3u rects %-3u overdraw %-2u flush %uK     ",
+            overlay_composites, overlay_rects_total, overdraw,
+            (flushed.width * flushed.height + 1023) >> 10);
+    }
+
+    if (overlay_rects_count > 0 && !overlay_flash_pending) {
+        overlay_flash_pending = 1;
+        gui_timeout_add(OVERLAY_FLASH_MSECS, gui_overlay_on_flash_timeout, NULL);
+    }
+
+    overlay_rects_count = 0;
+    overlay_rects_total = 0;
+    overlay_composites = 0;
+
+    gui_fb_draw_overlay_str(OVERLAY_READOUT_X, OVERLAY_READOUT_Y, overlay_readout,
+        OVERLAY_COLOR_READOUT, COLOR_BLACK);
+
+    return gui_overlay_readout_rect();
+}
+
+void
+gui_overlay_toggle(void)
+{
+    overlay_enabled = !overlay_enabled;
+
+    if (overlay_enabled) {
+        snprintf(overlay_readout, sizeof(overlay_readout), "overlay on");
+        gui_overlay_restore(gui_overlay_readout_rect());
+        return;
+    }
+
+    gui_overlay_restore(gui_rect_enclose(overlay_flashed, gui_overlay_readout_rect()));
+    overlay_flashed = (rect_st) { 0 };
+    overlay_rects_count = 0;
+    overlay_rects_total = 0;
+    overlay_composites = 0;
+}
@@ -13,11 +13,10 @@ enum {
     FB_PLANE_SIZE = GUI_HEIGHT * FB_PITCH,
 };
 
+// Only built in planar mode, every caller is under GUI_PLANAR_MODE as well
 #if GUI_PLANAR_MODE
+
 static uint8_t gui_planar_pixels[4][FB_PLANE_SIZE] __attribute__((aligned(16)));
-#else
-static uint8_t **gui_planar_pixels;
-#endif
 
 void
 gui_planar_flush(rect_st rect)
@@ -86,7 +85,12 @@ gui_planar_draw_pattern(rect_st dst_rect, bitmap_st *pattern, uint8_t c1, uint8_
     int pat_w = pattern->size.width;
     int pat_h = pattern->size.height;
 
-    uint8_t tile_pixels[pat_h * pat_w];
+    uint8_t *tile_pixels = krn_arena_alloc(&gui_frame_arena, pat_h * pat_w);
+
+    if (!tile_pixels) {
+        gui_planar_draw_rect(dst_rect, c2);
+        return;
+    }
 
     surface_st tile = {
         .size = pattern->size,
@@ -127,15 +131,12 @@ gui_planar_draw_pattern(rect_st dst_rect, bitmap_st *pattern, uint8_t c1, uint8_
 void
 gui_planar_draw_surface(int dst_x, int dst_y, surface_st *src, rect_st src_rect)
 {
-    if (src_rect.width <= 0 || src_rect.height <= 0) {
+    // The pixels of hidden windows may be unloaded, see gui/pool.c
+    if (src_rect.width <= 0 || src_rect.height <= 0 || !src->pixels) {
         return;
     }
 
-#if GUI_PLANAR_MODE
-    uint8_t (*dst)[FB_PLANE_SIZE] = (uint8_t (*)[FB_PLANE_SIZE])gui_planar_pixels;
-#else
-    uint8_t (*dst)[FB_PLANE_SIZE] = NULL;
-#endif
+    uint8_t (*dst)[FB_PLANE_SIZE] = gui_planar_pixels;
 
     int dst_l_x = dst_x;
     int dst_r_x = dst_x + src_rect.width - 1;
@@ -238,6 +239,45 @@ gui_planar_draw_surface(int dst_x, int dst_y, surface_st *src, rect_st src_rect)
     }
 }
 
+// Draw a glyph directly into the planar buffer. Glyph rows are 8 pixels wide,
+// so every row maps onto one byte per plane (two if x is not byte-aligned),
+// computed from the row bits and the plane fill masks of both colors.
+void
+gui_planar_draw_char(int x, int y, font_st *font, uint8_t ch, uint8_t fg, uint8_t bg)
+{
+    const uint8_t *glyph = font->pixels + (ch ? ch : ' ') * font->size.height;
+
+    int shift = x & 7;
+    uint8_t l_mask = 0xFF >> shift;
+    uint8_t r_mask = ~l_mask;
+
+    for (int plane = 0; plane < 4; ++plane) {
+        uint8_t fg_fill = ((fg >> plane) & 1) ? 0xFF : 0x00;
+        uint8_t bg_fill = ((bg >> plane) & 1) ? 0xFF : 0x00;
+        uint8_t *dst_row = gui_planar_pixels[plane] + y * FB_PITCH + x / 8;
+
+        for (int j = 0; j < font->size.height; ++j, dst_row += FB_PITCH) {
+            uint8_t val = (glyph[j] & fg_fill) | (~glyph[j] & bg_fill);
+
+            if (shift == 0) {
+                dst_row[0] = val;
+                continue;
+            }
+
+            dst_row[0] = (dst_row[0] & ~l_mask) | (val >> shift);
+            dst_row[1] = (dst_row[1] & ~r_mask) | (uint8_t)(val << (8 - shift));
+        }
+    }
+}
+
+void
+gui_planar_draw_str(int x, int y, font_st *font, const char *s, uint8_t fg, uint8_t bg)
+{
+    for (int i = 0; s[i]; i++) {
+        gui_planar_draw_char(x + i * font->size.width, y, font, s[i], fg, bg);
+    }
+}
+
 void
 gui_planar_draw_pointer(int dst_x, int dst_y)
 {
@@ -388,3 +428,5 @@ gui_planar_xor_corners(rect_st rect)
     gui_vga_set_logic_op(0x00);
     gui_vga_set_bit_mask(0xFF);
 }
+
+#endif
@@ -0,0 +1,203 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: pool.c - Shared memory pool for window surfaces
+// --------------------------------------------------------------------------------------
+
+#include <gui.h>
+
+enum {
+    POOL_SURFACES_MAX = 32,
+    POOL_RUN_MAX = 255,
+};
+
+typedef struct {
+    surface_st *surface;
+    const char *name;
+} pool_entry_st;
+
+static size_t pool_used = 0;
+
+static pool_entry_st pool_entries[POOL_SURFACES_MAX];
+static size_t pool_entries_count = 0;
+
+static void *
+gui_pool_alloc(size_t size)
+{
+    void *ret = krn_heap_alloc(size);
+
+    if (ret) {
+        pool_used += size;
+    }
+
+    return ret;
+}
+
+static void
+gui_pool_free(void *ptr, size_t size)
+{
+    if (ptr) {
+        krn_heap_free(ptr);
+        pool_used -= size;
+    }
+}
+
+static pool_entry_st *
+gui_pool_find_entry(surface_st *surface)
+{
+    for (size_t i = 0; i < pool_entries_count; ++i) {
+        if (pool_entries[i].surface == surface) {
+            return &pool_entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+static size_t
+gui_pool_packed_size(uint8_t *pixels, size_t count)
+{
+    size_t ret = 0;
+
+    for (size_t i = 0; i < count; ++ret) {
+        size_t run = 1;
+
+        while (i + run < count && run < POOL_RUN_MAX && pixels[i + run] == pixels[i]) {
+            ++run;
+        }
+
+        i += run;
+    }
+
+    return ret * 2;
+}
+
+// Pack the pixels as pairs of (run length, color)
+static void
+gui_pool_pack(uint8_t *dst, uint8_t *pixels, size_t count)
+{
+    for (size_t i = 0; i < count;) {
+        size_t run = 1;
+
+        while (i + run < count && run < POOL_RUN_MAX && pixels[i + run] == pixels[i]) {
+            ++run;
+        }
+
+        *dst++ = run;
+        *dst++ = pixels[i];
+        i += run;
+    }
+}
+
+static void
+gui_pool_unpack(uint8_t *pixels, uint8_t *src, size_t packed_size)
+{
+    for (size_t i = 0; i < packed_size; i += 2) {
+        memset(pixels, src[i + 1], src[i]);
+        pixels += src[i];
+    }
+}
+
+// Make sure the surface has pixels, allocating them on first use
+// or unpacking them if the surface was unloaded
+int
+gui_pool_load_surface(surface_st *surface, const char *name, int width, int height)
+{
+    size_t count = width * height;
+
+    if (surface->pixels) {
+        return 0;
+    }
+
+    uint8_t *pixels = gui_pool_alloc(count);
+
+    if (!pixels) {
+        gui_status_set_alert("Error: Not enough memory for %s", name);
+        return -1;
+    }
+
+    if (surface->packed) {
+        gui_pool_unpack(pixels, surface->packed, surface->packed_size);
+        gui_pool_free(surface->packed, surface->packed_size);
+        surface->packed = NULL;
+        surface->packed_size = 0;
+    } else {
+        // Start out blank, like the surfaces which used to be static
+        memset(pixels, 0, count);
+    }
+
+    surface->size.width = width;
+    surface->size.height = height;
+    surface->pitch = width;
+    surface->pixels = pixels;
+
+    if (!gui_pool_find_entry(surface) && pool_entries_count < POOL_SURFACES_MAX) {
+        pool_entries[pool_entries_count].surface = surface;
+        pool_entries[pool_entries_count].name = name;
+        pool_entries_count++;
+    }
+
+    return 0;
+}
+
+// Release the pixels of a surface that is no longer displayed,
+// keeping a packed copy for the next time it's loaded
+void
+gui_pool_unload_surface(surface_st *surface)
+{
+    size_t count = surface->size.width * surface->size.height;
+
+    if (!surface->pixels || !gui_pool_find_entry(surface)) {
+        return;
+    }
+
+    size_t packed_size = gui_pool_packed_size(surface->pixels, count);
+
+    // Not worth it, keep the pixels as they are
+    if (packed_size >= count) {
+        return;
+    }
+
+    uint8_t *packed = gui_pool_alloc(packed_size);
+
+    if (!packed) {
+        return;
+    }
+
+    gui_pool_pack(packed, surface->pixels, count);
+    gui_pool_free(surface->pixels, count);
+
+    surface->pixels = NULL;
+    surface->packed = packed;
+    surface->packed_size = packed_size;
+}
+
+size_t
+gui_pool_get_used(void)
+{
+    return pool_used;
+}
+
+size_t
+gui_pool_get_free(void)
+{
+    return krn_system_get_avail_mem();
+}
+
+// Get the name and memory usage of the idx-th surface in the pool.
+// Returns 0 if there is no such surface.
+int
+gui_pool_get_usage(size_t idx, const char **name, size_t *bytes)
+{
+    if (idx >= pool_entries_count) {
+        return 0;
+    }
+
+    surface_st *sf = pool_entries[idx].surface;
+
+    *name = pool_entries[idx].name;
+    *bytes = sf->pixels ? (size_t)(sf->size.width * sf->size.height) : sf->packed_size;
+
+    return 1;
+}
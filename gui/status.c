@@ -22,11 +22,12 @@ enum {
     TEXT_MAX_LEN = (STATUS_WIDTH / FONT_WIDTH) - 2,
 };
 
-static uint8_t window_pixels[STATUS_WIDTH * STATUS_HEIGHT];
 static surface_st window_surface;
 static window_st window;
 
+static char status_text[TEXT_MAX_LEN + 1];
 static size_t status_text_len = 0;
+static uint8_t status_text_color = 0;
 static uint8_t status_bg_color = 0;
 
 static void
@@ -44,42 +45,41 @@ gui_status_set_bg_color(uint8_t color)
     };
 
     gui_surface_draw_rect(window.surface, bg_rect, color);
-    gui_wm_render_window_region(&window, bg_rect);
+    gui_fb_draw_rect(gui_rect_translate(bg_rect, window.rect.pos), color);
 
+    // The repaint erased the text, so all of it needs to be drawn again
     status_bg_color = color;
+    status_text_len = 0;
 }
 
+// No window ever covers the status bar, so the text is drawn both to its surface
+// and straight to the framebuffer, bypassing the compositor. Only the glyph cells
+// which differ from the previous text are redrawn.
 static void
 gui_status_set_text(const char *text, uint8_t color)
 {
     size_t len = strlen(text);
     font_st *font = font_8x16;
 
-    gui_surface_draw_str(window.surface, TEXT_X, TEXT_Y, font, text, color,
-        status_bg_color);
+    for (size_t i = 0; i < MAX(len, status_text_len); ++i) {
+        char ch = i < len ? text[i] : ' ';
+        char prev = i < status_text_len ? status_text[i] : ' ';
 
-    // If the new text is shorter than previous, clear the remaining space
-    if (len < status_text_len) {
-        rect_st clear_rect = {
-            .x = TEXT_X + len * font->size.width,
-            .y = TEXT_Y,
-            .width = (status_text_len - len) * font->size.width,
-            .height = font->size.height,
-        };
+        if (ch == prev && (ch == ' ' || color == status_text_color)) {
+            continue;
+        }
 
-        gui_surface_draw_rect(window.surface, clear_rect, status_bg_color);
-    }
-
-    rect_st text_rect = {
-        .x = TEXT_X,
-        .y = TEXT_Y,
-        .width = STATUS_WIDTH - TEXT_X * 2,
-        .height = font->size.height,
-    };
+        int x = TEXT_X + i * font->size.width;
 
-    gui_wm_render_window_region(&window, text_rect);
+        gui_surface_draw_char(window.surface, x, TEXT_Y, font, ch, color,
+            status_bg_color);
+        gui_fb_draw_char(window.rect.x + x, window.rect.y + TEXT_Y, font, ch, color,
+            status_bg_color);
+    }
 
+    memcpy(status_text, text, len + 1);
     status_text_len = len;
+    status_text_color = color;
 }
 
 void
@@ -89,6 +89,10 @@ gui_status_set(const char *fmt, ...)
 
     va_list args;
 
+    if (!window.visible) {
+        return;
+    }
+
     va_start(args, fmt);
     (void) vsnprintf(buf, sizeof(buf), fmt, args);
     va_end(args);
@@ -105,6 +109,10 @@ gui_status_set_alert(const char *fmt, ...)
 
     va_list args;
 
+    if (!window.visible) {
+        return;
+    }
+
     va_start(args, fmt);
     (void) vsnprintf(buf, sizeof(buf), fmt, args);
     va_end(args);
@@ -116,10 +124,11 @@ gui_status_set_alert(const char *fmt, ...)
 void
 gui_status_init(void)
 {
-    window_surface.size.width = STATUS_WIDTH;
-    window_surface.size.height = STATUS_HEIGHT;
-    window_surface.pitch = STATUS_WIDTH;
-    window_surface.pixels = window_pixels;
+    if (gui_pool_load_surface(&window_surface, "Status", STATUS_WIDTH,
+        STATUS_HEIGHT) != 0) {
+
+        return;
+    }
 
     window.rect.x = 0;
     window.rect.y = GUI_HEIGHT - STATUS_HEIGHT;
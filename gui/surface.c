@@ -7,10 +7,22 @@
 
 #include <gui.h>
 
+// The pixels of a surface are released while its window is hidden, see gui/pool.c,
+// so drawing into it or copying from it is skipped until they're loaded again
+static int
+gui_surface_is_unloaded(surface_st *surface)
+{
+    return surface->pixels == NULL;
+}
+
 void
 gui_surface_copy(surface_st *dst_sf, int dst_x, int dst_y,
     surface_st *src_sf, rect_st src_rect)
 {
+    if (gui_surface_is_unloaded(dst_sf) || gui_surface_is_unloaded(src_sf)) {
+        return;
+    }
+
     if (dst_x + src_rect.width > dst_sf->size.width) {
         src_rect.width = dst_sf->size.width - dst_x;
         src_rect.width = MAX(src_rect.width, 0);
@@ -42,15 +54,41 @@ gui_surface_copy(surface_st *dst_sf, int dst_x, int dst_y,
     }
 }
 
+// Move the pixels inside of rect horizontally by dx, leaving the columns
+// which were uncovered unchanged
+void
+gui_surface_scroll(surface_st *surface, rect_st rect, int dx)
+{
+    int width = rect.width - (dx < 0 ? -dx : dx);
+
+    if (width <= 0 || gui_surface_is_unloaded(surface)) {
+        return;
+    }
+
+    for (int i = 0; i < rect.height; ++i) {
+        uint8_t *row = surface->pixels + (rect.y + i) * surface->pitch + rect.x;
+
+        memmove(row + MAX(dx, 0), row + MAX(-dx, 0), width);
+    }
+}
+
 void
 gui_surface_draw_h_seg(surface_st *surface, int x, int y, int w, uint8_t color)
 {
+    if (gui_surface_is_unloaded(surface)) {
+        return;
+    }
+
     memset(surface->pixels + y * surface->pitch + x, color, w);
 }
 
 void
 gui_surface_draw_v_seg(surface_st *surface, int x, int y, int h, uint8_t color)
 {
+    if (gui_surface_is_unloaded(surface)) {
+        return;
+    }
+
     for (int i = 0; i < h; i++) {
         surface->pixels[(y + i) * surface->pitch + x] = color;
     }
@@ -82,6 +120,10 @@ gui_surface_draw_char(surface_st *surface, uint16_t x, uint16_t y,
     size_t npixel;
     int i, j;
 
+    if (gui_surface_is_unloaded(surface)) {
+        return;
+    }
+
     if (!ch) {
         ch = ' ';
     }
@@ -125,6 +167,10 @@ gui_surface_draw_bitmap(surface_st *surface, int dst_x, int dst_y, bitmap_st *bi
     uint8_t alpha = (uint8_t)bitmap->alpha;
     uint8_t foreground = (uint8_t)bitmap->foreground;
 
+    if (gui_surface_is_unloaded(surface)) {
+        return;
+    }
+
     rect_st src_rect = {
         .x = 0,
         .y = 0,
@@ -170,6 +216,10 @@ void
 gui_surface_draw_pattern(surface_st *surface, rect_st reg,
     bitmap_st *b, uint8_t col1, uint8_t col2)
 {
+    if (gui_surface_is_unloaded(surface)) {
+        return;
+    }
+
     for (uint16_t y = reg.y; y < reg.y + reg.height; y++) {
         for (uint16_t x = reg.x; x < reg.x + reg.width; x++) {
             size_t src_pixel_no = ((y % b->size.height) * b->size.width) +
@@ -8,99 +8,272 @@
 #include <gui.h>
 
 #define TIMEOUTS_MAX_COUNT 32
+#define TIMEOUTS_STATS_COUNT 16
 
 typedef struct {
-    uint32_t msecs;
+    uint32_t expires_at;
+    uint32_t period;
     timeout_callback_fn callback;
     void *payload;
 
     uint64_t id;
-    uint32_t initialized;
-    uint32_t added_at;
-    uint32_t expires_at;
+    uint16_t heap_idx;
+    uint8_t active;
 } timeout_st;
 
+typedef struct {
+    timeout_callback_fn callback;
+    uint32_t fired;
+    uint32_t late_total;
+    uint32_t late_max;
+} timeout_stats_st;
+
+// Timeouts are kept in fixed slots, while the heap orders
+// slot numbers by expiration time, earliest first
 static timeout_st timeouts[TIMEOUTS_MAX_COUNT];
+static uint8_t timeout_heap[TIMEOUTS_MAX_COUNT];
 static unsigned timeout_count = 0;
-static uint64_t timeout_id = 1;
+static uint32_t timeout_generation = 1;
 
-void
-gui_timeout_remove(uint64_t id)
+static timeout_stats_st timeout_stats[TIMEOUTS_STATS_COUNT];
+static uint32_t timeout_late_max = 0;
+
+static int
+gui_timeout_before(unsigned heap_a, unsigned heap_b)
+{
+    timeout_st *a = &timeouts[timeout_heap[heap_a]];
+    timeout_st *b = &timeouts[timeout_heap[heap_b]];
+
+    return (int32_t)(a->expires_at - b->expires_at) < 0;
+}
+
+static void
+gui_timeout_swap(unsigned i, unsigned j)
+{
+    uint8_t tmp = timeout_heap[i];
+
+    timeout_heap[i] = timeout_heap[j];
+    timeout_heap[j] = tmp;
+
+    timeouts[timeout_heap[i]].heap_idx = i;
+    timeouts[timeout_heap[j]].heap_idx = j;
+}
+
+static void
+gui_timeout_sift_up(unsigned i)
+{
+    while (i > 0 && gui_timeout_before(i, (i - 1) / 2)) {
+        gui_timeout_swap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void
+gui_timeout_sift_down(unsigned i)
+{
+    while (1) {
+        unsigned min = i;
+        unsigned l = i * 2 + 1;
+        unsigned r = i * 2 + 2;
+
+        if (l < timeout_count && gui_timeout_before(l, min)) {
+            min = l;
+        }
+
+        if (r < timeout_count && gui_timeout_before(r, min)) {
+            min = r;
+        }
+
+        if (min == i) {
+            return;
+        }
+
+        gui_timeout_swap(i, min);
+        i = min;
+    }
+}
+
+static void
+gui_timeout_heap_insert(unsigned slot)
+{
+    timeout_heap[timeout_count] = slot;
+    timeouts[slot].heap_idx = timeout_count;
+    timeout_count++;
+
+    gui_timeout_sift_up(timeout_count - 1);
+}
+
+static void
+gui_timeout_heap_remove(unsigned i)
+{
+    timeout_count--;
+
+    if (i == timeout_count) {
+        return;
+    }
+
+    gui_timeout_swap(i, timeout_count);
+    gui_timeout_sift_down(i);
+    gui_timeout_sift_up(i);
+}
+
+// Ids contain the slot number in the low bits, and a generation counter
+// in the high bits so that stale ids don't match reused slots
+static timeout_st *
+gui_timeout_find(uint64_t id)
+{
+    timeout_st *tm = &timeouts[id % TIMEOUTS_MAX_COUNT];
+
+    return (tm->active && tm->id == id) ? tm : NULL;
+}
+
+static void
+gui_timeout_record(timeout_callback_fn callback, uint32_t late)
 {
-    size_t i;
+    timeout_stats_st *st = NULL;
+
+    timeout_late_max = MAX(timeout_late_max, late);
 
-    for (i = 0; i < TIMEOUTS_MAX_COUNT; ++i) {
-        if (timeouts[i].id == id) {
+    for (size_t i = 0; i < TIMEOUTS_STATS_COUNT; ++i) {
+        if (timeout_stats[i].callback == callback || !timeout_stats[i].callback) {
+            st = &timeout_stats[i];
             break;
         }
     }
 
-    if (i == TIMEOUTS_MAX_COUNT) {
+    if (!st) {
         return;
     }
 
-    --timeout_count;
+    st->callback = callback;
+    st->fired++;
+    st->late_total += late;
+    st->late_max = MAX(st->late_max, late);
+}
+
+void
+gui_timeout_remove(uint64_t id)
+{
+    timeout_st *tm = gui_timeout_find(id);
 
-    for (; i < timeout_count; ++i) {
-        timeouts[i] = timeouts[i + 1];
+    if (!tm) {
+        return;
     }
+
+    tm->active = 0;
+    gui_timeout_heap_remove(tm->heap_idx);
 }
 
-int
-gui_timeout_add(uint32_t msecs, timeout_callback_fn callback, timeout_payload payload)
+static int
+gui_timeout_schedule(uint32_t msecs, uint32_t period, timeout_callback_fn callback,
+    timeout_payload payload)
 {
-    if (timeout_count >= TIMEOUTS_MAX_COUNT) {
+    unsigned slot;
+
+    for (slot = 0; slot < TIMEOUTS_MAX_COUNT; ++slot) {
+        if (!timeouts[slot].active) {
+            break;
+        }
+    }
+
+    if (slot == TIMEOUTS_MAX_COUNT) {
         return 0;
     }
 
-    uint64_t id = timeout_id++;
+    timeout_st *tm = &timeouts[slot];
 
-    if (timeout_id == 0) {
-        ++timeout_id;
-    }
+    tm->id = timeout_generation++ * TIMEOUTS_MAX_COUNT + slot;
+    tm->active = 1;
+    tm->expires_at = krn_timer_get_msecs() + msecs;
+    tm->period = period;
+    tm->callback = callback;
+    tm->payload = payload;
 
-    timeouts[timeout_count].id = id;
-    timeouts[timeout_count].initialized = 0;
-    timeouts[timeout_count].msecs = msecs;
-    timeouts[timeout_count].callback = callback;
-    timeouts[timeout_count].payload = payload;
-    timeout_count++;
+    gui_timeout_heap_insert(slot);
 
-    return id;
+    return tm->id;
 }
 
-void
-gui_timeout_on_tick(event_st event)
+int
+gui_timeout_add(uint32_t msecs, timeout_callback_fn callback, timeout_payload payload)
 {
-    timeout_st *tm;
+    return gui_timeout_schedule(msecs, 0, callback, payload);
+}
 
-    for (unsigned i = 0; i < timeout_count; i++) {
-        tm = &timeouts[i];
+// Call the callback every msecs until the timeout is removed. The next
+// expiration is counted from the previous one, so delays don't accumulate.
+int
+gui_timeout_add_periodic(uint32_t msecs, timeout_callback_fn callback,
+    timeout_payload payload)
+{
+    return gui_timeout_schedule(msecs, MAX(msecs, 1), callback, payload);
+}
 
-        if (tm->initialized == 0) {
-            tm->initialized = 1;
-            tm->added_at = event.timer_msecs;
-            tm->expires_at = event.timer_msecs + tm->msecs;
-            continue;
-        }
+// Run all expired callbacks in the order of their expiration
+void
+gui_timeout_on_tick(event_st event _unsd)
+{
+    uint32_t now = krn_timer_get_msecs();
 
-        // Check timeout that was scheduled before overflow of the timer
-        if (tm->expires_at >= tm->added_at &&
-            (event.timer_msecs >= tm->expires_at || event.timer_msecs < tm->added_at)) {
+    // Limit the number of calls, in case callbacks keep adding expired timeouts
+    for (int i = 0; i < TIMEOUTS_MAX_COUNT * 2 && timeout_count > 0; ++i) {
+        timeout_st *tm = &timeouts[timeout_heap[0]];
+        int32_t late = now - tm->expires_at;
 
-            tm->callback(tm->payload);
-            gui_timeout_remove(tm->id);
+        if (late < 0) {
             break;
         }
 
-        // Check timeout that was scheduled after overflow of the timer
-        if (tm->expires_at < tm->added_at &&
-            (event.timer_msecs >= tm->expires_at && event.timer_msecs < tm->added_at)) {
+        gui_timeout_record(tm->callback, late);
 
-            tm->callback(tm->payload);
-            gui_timeout_remove(tm->id);
-            break;
+        timeout_callback_fn callback = tm->callback;
+        void *payload = tm->payload;
+
+        // Reschedule or remove the timeout first, so the callback can remove
+        // it or add new ones. Periods missed entirely are skipped.
+        if (tm->period) {
+            do {
+                tm->expires_at += tm->period;
+            } while ((int32_t)(now - tm->expires_at) >= 0);
+
+            gui_timeout_sift_down(0);
+        } else {
+            tm->active = 0;
+            gui_timeout_heap_remove(0);
         }
+
+        callback(payload);
     }
 }
 
+// Ask the timer for a tick when the earliest timeout expires
+void
+gui_timeout_set_deadline(void)
+{
+    if (timeout_count > 0) {
+        krn_timer_set_deadline(timeouts[timeout_heap[0]].expires_at);
+    }
+}
+
+void
+gui_timeout_dump_stats(void)
+{
+    for (size_t i = 0; i < TIMEOUTS_STATS_COUNT && timeout_stats[i].callback; ++i) {
+        timeout_stats_st *st = &timeout_stats[i];
+
+        krn_debug_printf("timeouts: %08x fired: %u, late avg: %u ms, max: %u ms\n",
+            (uint32_t)(uintptr_t)st->callback, st->fired, st->late_total / st->fired,
+            st->late_max);
+    }
+}
+
+// Get the maximum lateness of the callbacks fired since the last call, in msecs
+uint32_t
+gui_timeout_take_late_max(void)
+{
+    uint32_t ret = timeout_late_max;
+
+    timeout_late_max = 0;
+
+    return ret;
+}
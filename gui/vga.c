@@ -8,6 +8,20 @@
 #include <gui.h>
 #include "vga.h"
 
+enum {
+    VGA_SEQ_REGS = 5,
+    VGA_GC_REGS = 9,
+    VGA_STATS_DEBUG = 0,
+    VGA_STATS_INTERVAL = 5000,
+};
+
+// Shadow copies of the sequencer and graphics controller registers, see vga.h
+uint8_t gui_vga_seq_shadow[8];
+uint8_t gui_vga_gc_shadow[16];
+
+uint32_t gui_vga_reg_writes = 0;
+uint32_t gui_vga_reg_skips = 0;
+
 #if GUI_PLANAR_MODE
 static const uint8_t gui_vga_dac_indexes[16] = {
     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x14, 0x07,
@@ -30,9 +44,42 @@ gui_vga_set_color(int index, uint32_t rgb)
     outb((rgb >>  2) & 0x3F, 0x3C9);
 }
 
+static uint8_t
+gui_vga_read_reg(uint16_t port, uint8_t index)
+{
+    outb(index, port);
+    return inb(port + 1);
+}
+
+void
+gui_vga_dump_stats(void)
+{
+    krn_debug_printf("vga: %u register writes, %u skipped, %u port I/O operations\n",
+        gui_vga_reg_writes, gui_vga_reg_skips, cpu_io_count);
+}
+
+static void
+gui_vga_on_stats_timeout(timeout_payload payload _unsd)
+{
+    gui_vga_dump_stats();
+}
+
 void
 gui_vga_init(void)
 {
+    // Start with the shadow registers in sync with the hardware
+    for (int i = 0; i < VGA_SEQ_REGS; ++i) {
+        gui_vga_seq_shadow[i] = gui_vga_read_reg(VGA_SEQ_PORT, i);
+    }
+
+    for (int i = 0; i < VGA_GC_REGS; ++i) {
+        gui_vga_gc_shadow[i] = gui_vga_read_reg(VGA_GC_PORT, i);
+    }
+
+    if (VGA_STATS_DEBUG) {
+        gui_timeout_add_periodic(VGA_STATS_INTERVAL, gui_vga_on_stats_timeout, NULL);
+    }
+
     gui_vga_set_color(0x09, 0x3366aa);
     gui_vga_set_color(0x0e, 0xffcc00);
 
@@ -5,30 +5,49 @@
 // File: vga.h - Inline routines for programming the VGA
 // --------------------------------------------------------------------------------------
 
-#include <kernel.h>
+#include <gui.h>
+
+enum {
+    VGA_SEQ_PORT = 0x3C4,
+    VGA_GC_PORT = 0x3CE,
+};
+
+// Write an indexed register, unless the shadow copy says it already has the value
+static inline void
+gui_vga_write_reg(uint8_t *shadow, uint16_t port, uint8_t index, uint8_t value)
+{
+    if (shadow[index] == value) {
+        gui_vga_reg_skips++;
+        return;
+    }
+
+    shadow[index] = value;
+    gui_vga_reg_writes++;
+    outw((value << 8) | index, port);
+}
 
 static inline void
 gui_vga_set_write_planes(uint8_t plane_mask)
 {
-    outw((plane_mask << 8) | 0x02, 0x3C4);
+    gui_vga_write_reg(gui_vga_seq_shadow, VGA_SEQ_PORT, 0x02, plane_mask);
 }
 
 static inline void
 gui_vga_set_bit_mask(uint8_t mask)
 {
-    outw((mask << 8) | 0x08, 0x3CE);
+    gui_vga_write_reg(gui_vga_gc_shadow, VGA_GC_PORT, 0x08, mask);
 }
 
 static inline void
 gui_vga_set_write_mode(uint8_t mode)
 {
-    outw((mode << 8) | 0x05, 0x3CE);
+    gui_vga_write_reg(gui_vga_gc_shadow, VGA_GC_PORT, 0x05, mode);
 }
 
 static inline void
 gui_vga_set_logic_op(uint8_t op)
 {
-    outw((op << 8) | 0x03, 0x3CE);
+    gui_vga_write_reg(gui_vga_gc_shadow, VGA_GC_PORT, 0x03, op);
 }
 
 static inline void
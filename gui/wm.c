@@ -113,6 +113,8 @@ gui_wm_remove_window(struct window *w)
     }
 
     gui_wm_render_desktop_region(w->rect, NULL);
+
+    gui_pool_unload_surface(w->surface);
 }
 
 static void
@@ -148,6 +150,8 @@ gui_wm_render_desktop_region(rect_st rect, window_st *bottom_window)
     window_st *w;
     int started = (bottom_window == NULL);
 
+    gui_overlay_on_composite();
+
     if (!bottom_window) {
         gui_wm_render_wallpaper(rect);
     }
@@ -165,6 +169,24 @@ gui_wm_render_desktop_region(rect_st rect, window_st *bottom_window)
     }
 }
 
+// Re-render any region of the screen, including the panel and the status bar
+void
+gui_wm_render_screen_region(rect_st rect)
+{
+    rect_st desktop_reg = gui_rect_clip(rect, gui_wm_container);
+    window_st *fixed[2] = { gui_wm_panel_window, gui_wm_status_window };
+
+    if (!gui_rect_is_empty(desktop_reg)) {
+        gui_wm_render_desktop_region(desktop_reg, NULL);
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        if (fixed[i] && !gui_rect_is_empty(gui_rect_clip(rect, fixed[i]->rect))) {
+            gui_wm_render_window_surface(fixed[i], rect);
+        }
+    }
+}
+
 void
 gui_wm_render_window_region(window_st *window, rect_st window_reg)
 {
@@ -207,6 +229,19 @@ gui_wm_find_window(uint16_t x, uint16_t y)
     return NULL;
 }
 
+// Let all open windows know that the wall clock time changed
+void
+gui_wm_on_time_change(event_st event)
+{
+    for (size_t i = 0; i < WINDOWS_COUNT_MAX && gui_wm_windows[i]; ++i) {
+        window_st *w = gui_wm_windows[i];
+
+        if (w->on_time_change) {
+            w->on_time_change(w, event);
+        }
+    }
+}
+
 window_st *
 gui_wm_top_window(void)
 {
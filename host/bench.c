@@ -0,0 +1,282 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: bench.c - Microbenchmarks of drawing primitives, run on the host
+// --------------------------------------------------------------------------------------
+
+#include <gui.h>
+#include "host.h"
+
+enum {
+    BENCH_MIN_NSECS = 20000000,
+    BENCH_MAX_ITERS = 1 << 30,
+    BENCH_RUNS = 5,
+
+    BENCH_BUF_SIZE = GUI_WIDTH * GUI_HEIGHT + 64,
+};
+
+typedef struct {
+    int width;
+    int height;
+    int offset;
+} bench_case_st;
+
+typedef void (*bench_fn)(bench_case_st *c, uint32_t iters);
+
+typedef struct {
+    const char *name;
+    bench_fn fn;
+    int on_screen;
+} bench_st;
+
+static const uint32_t bench_sizes[] = { 64, 1024, 16384, GUI_WIDTH * GUI_HEIGHT };
+static const size_st bench_rects[] = {
+    { 16, 16 }, { 64, 64 }, { 256, 256 }, { GUI_WIDTH, GUI_HEIGHT },
+};
+static const int bench_offsets[] = { 0, 3 };
+
+static uint8_t *bench_src;
+static uint8_t *bench_dst;
+
+static surface_st bench_src_surface;
+static surface_st bench_dst_surface;
+
+static surface_st bench_window_surfaces[2];
+static window_st bench_windows[2];
+
+// Fill with a pattern which doesn't compress, so that nothing takes shortcuts
+static void
+bench_fill(uint8_t *buf, size_t size)
+{
+    uint32_t x = 0x12345678;
+
+    for (size_t i = 0; i < size; ++i) {
+        x = x * 1103515245 + 12345;
+        buf[i] = x >> 24;
+    }
+}
+
+static void
+bench_memcpy(bench_case_st *c, uint32_t iters)
+{
+    for (uint32_t i = 0; i < iters; ++i) {
+        memcpy(bench_dst + c->offset, bench_src, c->width);
+        cpu_barrier();
+    }
+}
+
+static void
+bench_memset(bench_case_st *c, uint32_t iters)
+{
+    for (uint32_t i = 0; i < iters; ++i) {
+        memset(bench_dst + c->offset, i, c->width);
+        cpu_barrier();
+    }
+}
+
+static void
+bench_surface_copy(bench_case_st *c, uint32_t iters)
+{
+    rect_st rect = { .x = 0, .y = 0, .width = c->width, .height = c->height };
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_surface_copy(&bench_dst_surface, c->offset, 0, &bench_src_surface, rect);
+        cpu_barrier();
+    }
+}
+
+static void
+bench_draw_char(bench_case_st *c, uint32_t iters)
+{
+    font_st *font = c->height == 16 ? font_8x16 : font_8x8;
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_surface_draw_char(&bench_dst_surface, c->offset, 0, font, 'A' + (i & 15),
+            COLOR_BLACK, COLOR_WHITE);
+        cpu_barrier();
+    }
+}
+
+#if GUI_PLANAR_MODE
+static void
+bench_planar_draw_surface(bench_case_st *c, uint32_t iters)
+{
+    rect_st rect = { .x = 0, .y = 0, .width = c->width, .height = c->height };
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_planar_draw_surface(c->offset, 0, &bench_src_surface, rect);
+        cpu_barrier();
+    }
+}
+#endif
+
+static void
+bench_wm_render(bench_case_st *c, uint32_t iters)
+{
+    rect_st rect = { .x = c->offset, .y = 0, .width = c->width, .height = c->height };
+
+    for (uint32_t i = 0; i < iters; ++i) {
+        gui_wm_render_desktop_region(rect, NULL);
+        cpu_barrier();
+    }
+}
+
+static const bench_st bench_list[] = {
+    { "memcpy", bench_memcpy, 0 },
+    { "memset", bench_memset, 0 },
+    { "gui_surface_copy", bench_surface_copy, 0 },
+    { "gui_surface_draw_char", bench_draw_char, 0 },
+#if GUI_PLANAR_MODE
+    { "gui_planar_draw_surface", bench_planar_draw_surface, 1 },
+#endif
+    { "gui_wm_render_desktop_region", bench_wm_render, 1 },
+};
+
+// Time a benchmark with enough iterations to be measurable,
+// and report the best of several runs, as the others were disturbed by the host
+static void
+bench_measure(const char *name, bench_fn fn, bench_case_st *c, uint32_t bytes)
+{
+    char variant[32];
+    uint32_t iters = 1;
+    uint64_t best;
+
+    for (;;) {
+        uint64_t start = host_get_nsecs();
+        fn(c, iters);
+        best = host_get_nsecs() - start;
+
+        if (best >= BENCH_MIN_NSECS || iters >= BENCH_MAX_ITERS) {
+            break;
+        }
+
+        iters *= 2;
+    }
+
+    for (int run = 1; run < BENCH_RUNS; ++run) {
+        uint64_t start = host_get_nsecs();
+        fn(c, iters);
+        best = MIN(best, host_get_nsecs() - start);
+    }
+
+    if (c->height > 0) {
+        snprintf(variant, sizeof(variant), "%dx%d+%d", c->width, c->height, c->offset);
+    } else {
+        snprintf(variant, sizeof(variant), "%d+%d", c->width, c->offset);
+    }
+
+    host_bench_result(name, variant, bytes, iters, best);
+}
+
+static void
+bench_run(const bench_st *b)
+{
+    bench_case_st c;
+
+    for (size_t oi = 0; oi < sizeof(bench_offsets) / sizeof(bench_offsets[0]); ++oi) {
+        c.offset = bench_offsets[oi];
+
+        if (b->fn == bench_memcpy || b->fn == bench_memset) {
+            for (size_t si = 0; si < sizeof(bench_sizes) / sizeof(bench_sizes[0]); ++si) {
+                c.width = bench_sizes[si];
+                c.height = 0;
+                bench_measure(b->name, b->fn, &c, c.width);
+            }
+        } else if (b->fn == bench_draw_char) {
+            for (int height = 8; height <= 16; height += 8) {
+                c.width = 8;
+                c.height = height;
+                bench_measure(b->name, b->fn, &c, c.width * c.height);
+            }
+        } else {
+            for (size_t ri = 0; ri < sizeof(bench_rects) / sizeof(bench_rects[0]); ++ri) {
+                c.width = bench_rects[ri].width;
+                c.height = bench_rects[ri].height;
+
+                // Drawing to the screen can't go past its edge
+                if (b->on_screen && c.offset + c.width > GUI_WIDTH) {
+                    continue;
+                }
+
+                bench_measure(b->name, b->fn, &c, c.width * c.height);
+            }
+        }
+    }
+}
+
+static void
+bench_init_surface(surface_st *surface, int width, int height)
+{
+    surface->size.width = width;
+    surface->size.height = height;
+    surface->pitch = width;
+    surface->pixels = krn_heap_alloc(width * height);
+
+    if (!surface->pixels) {
+        host_log("bench: not enough memory\n");
+        host_exit(1);
+    }
+
+    bench_fill(surface->pixels, width * height);
+}
+
+// Set up a desktop with two overlapping windows
+static void
+bench_init_windows(void)
+{
+    for (int i = 0; i < 2; ++i) {
+        window_st *w = &bench_windows[i];
+
+        bench_init_surface(&bench_window_surfaces[i], 320, 240);
+
+        w->surface = &bench_window_surfaces[i];
+        w->rect.x = 40 + i * 160;
+        w->rect.y = 40 + i * 120;
+        w->rect.width = 320;
+        w->rect.height = 240;
+        w->title = "Bench";
+
+        gui_wm_add_window(w);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *mode = GUI_PLANAR_MODE ? "planar" : "chunky";
+
+    host_kernel_init();
+
+    gui_vga_init();
+    gui_fb_init();
+
+    bench_src = krn_heap_alloc(BENCH_BUF_SIZE);
+    bench_dst = krn_heap_alloc(BENCH_BUF_SIZE);
+
+    if (!bench_src || !bench_dst) {
+        host_log("bench: not enough memory\n");
+        return 1;
+    }
+
+    bench_fill(bench_src, BENCH_BUF_SIZE);
+
+    bench_init_surface(&bench_src_surface, GUI_WIDTH, GUI_HEIGHT);
+    bench_init_surface(&bench_dst_surface, GUI_WIDTH + 8, GUI_HEIGHT);
+    bench_init_windows();
+
+    for (size_t i = 0; i < sizeof(bench_list) / sizeof(bench_list[0]); ++i) {
+        // Primitives which don't draw to the screen are the same in both modes
+        if (GUI_PLANAR_MODE && !bench_list[i].on_screen) {
+            continue;
+        }
+
+        bench_run(&bench_list[i]);
+    }
+
+    if (argc > 1 && host_bench_write_json(argv[1], mode) != 0) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: host.c - Services of the host C library
+// --------------------------------------------------------------------------------------
+
+// This file is built against the headers of the host instead of lib.h,
+// everything else only talks to the host through the functions below.
+// Note that functions of lib/ like memcpy or snprintf are linked into the same
+// program, so they take precedence over the ones of the C library here, too.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "host.h"
+
+enum {
+    BENCH_RESULTS_MAX = 256,
+    BENCH_NAME_LEN = 40,
+};
+
+typedef struct {
+    char name[BENCH_NAME_LEN];
+    char variant[BENCH_NAME_LEN];
+    uint32_t bytes;
+    uint32_t iters;
+    double nsecs_per_op;
+    double bytes_per_sec;
+} bench_result_st;
+
+static bench_result_st bench_results[BENCH_RESULTS_MAX];
+static int bench_results_count = 0;
+
+uint64_t
+host_get_nsecs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void *
+host_alloc(uint32_t size)
+{
+    return calloc(1, size);
+}
+
+void
+host_free(void *ptr)
+{
+    free(ptr);
+}
+
+void
+host_log(const char *s)
+{
+    fputs(s, stderr);
+}
+
+void
+host_print(const char *s)
+{
+    fputs(s, stdout);
+}
+
+// Read a whole file, followed by a terminating zero. Returns NULL on failure.
+char *
+host_read_file(const char *path, uint32_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    char *ret = NULL;
+    long len;
+
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+
+    if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+        ret = malloc(len + 1);
+    }
+
+    if (ret && fread(ret, 1, len, f) == (size_t)len) {
+        ret[len] = 0;
+        *size = len;
+    } else {
+        perror(path);
+        free(ret);
+        ret = NULL;
+    }
+
+    fclose(f);
+    return ret;
+}
+
+int
+host_write_file(const char *path, const void *data, uint32_t size)
+{
+    FILE *f = fopen(path, "wb");
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    size_t written = fwrite(data, 1, size, f);
+
+    if (fclose(f) != 0 || written != size) {
+        perror(path);
+        return -1;
+    }
+
+    return 0;
+}
+
+void
+host_exit(int status)
+{
+    fflush(stdout);
+    exit(status);
+}
+
+// Record the time taken by iters operations on the given number of bytes each
+void
+host_bench_result(const char *name, const char *variant, uint32_t bytes,
+    uint32_t iters, uint64_t nsecs)
+{
+    bench_result_st r = {
+        .bytes = bytes,
+        .iters = iters,
+        .nsecs_per_op = (double)nsecs / iters,
+        .bytes_per_sec = nsecs ? (double)bytes * iters * 1e9 / nsecs : 0,
+    };
+
+    strncpy(r.name, name, BENCH_NAME_LEN - 1);
+    strncpy(r.variant, variant, BENCH_NAME_LEN - 1);
+
+    printf("%-32s %-16s %12.1f ns/op %10.1f MB/s\n", r.name, r.variant,
+        r.nsecs_per_op, r.bytes_per_sec / 1e6);
+
+    if (bench_results_count < BENCH_RESULTS_MAX) {
+        bench_results[bench_results_count++] = r;
+    }
+}
+
+// Write all results as JSON, so that they can be compared across commits
+int
+host_bench_write_json(const char *path, const char *mode)
+{
+    FILE *f = fopen(path, "w");
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    fprintf(f, "{\n  \"mode\": \"%s\",\n  \"results\": [\n", mode);
+
+    for (int i = 0; i < bench_results_count; ++i) {
+        bench_result_st *r = &bench_results[i];
+
+        fprintf(f, "    {\"name\": \"%s\", \"variant\": \"%s\", \"bytes\": %u, "
+            "\"iters\": %u, \"ns_per_op\": %.2f, \"bytes_per_sec\": %.0f}%s\n",
+            r->name, r->variant, r->bytes, r->iters, r->nsecs_per_op, r->bytes_per_sec,
+            i + 1 < bench_results_count ? "," : "");
+    }
+
+    fprintf(f, "  ]\n}\n");
+
+    return fclose(f) == 0 ? 0 : -1;
+}
@@ -0,0 +1,39 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: host.h - Services of the host C library, usable from code built against lib.h
+// --------------------------------------------------------------------------------------
+
+#ifndef _HOST_H_
+#define _HOST_H_
+
+#include <stdint.h>
+
+// host/host.c
+uint64_t host_get_nsecs(void);
+void *host_alloc(uint32_t size);
+void host_free(void *ptr);
+void host_log(const char *s);
+void host_print(const char *s);
+char *host_read_file(const char *path, uint32_t *size);
+int host_write_file(const char *path, const void *data, uint32_t size);
+void host_exit(int status);
+void host_bench_result(const char *name, const char *variant, uint32_t bytes,
+    uint32_t iters, uint64_t nsecs);
+int host_bench_write_json(const char *path, const char *mode);
+
+// host/kernel.c
+extern uint8_t host_palette[256 * 3];
+extern uint32_t host_kernel_events_popped;
+extern void (*host_kernel_on_frame)(void);
+extern void (*host_kernel_on_idle)(void);
+void host_kernel_init(void);
+int host_kernel_get_deadline(uint32_t *msecs);
+void host_kernel_advance(uint32_t msecs);
+
+#ifdef _KERNEL_H_
+int host_kernel_push_event(event_st event);
+#endif
+
+#endif // _HOST_H_
@@ -0,0 +1,14 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: config.h - Configuration for building the GUI on the host
+// --------------------------------------------------------------------------------------
+
+// Use the configuration of the target, but let the Makefile build both video modes
+#include "../../include/config.h"
+
+#ifdef HOST_GUI_PLANAR_MODE
+#undef GUI_PLANAR_MODE
+#define GUI_PLANAR_MODE HOST_GUI_PLANAR_MODE
+#endif
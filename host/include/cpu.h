@@ -0,0 +1,91 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: cpu.h - Fake CPU primitives for building the GUI on the host
+// --------------------------------------------------------------------------------------
+
+#ifndef _CPU_H_
+#define _CPU_H_
+
+#include <stdint.h>
+
+// Number of port I/O operations, see host/kernel.c
+extern uint32_t cpu_io_count;
+
+// Last value written to every port, returned by subsequent reads
+extern uint8_t cpu_fake_ports[0x10000];
+
+void cpu_fake_dac_write(uint16_t port, uint8_t value);
+
+static inline uint32_t
+cpu_get_eflags(void)
+{
+    return 0;
+}
+
+static inline void
+cpu_set_eflags(uint32_t eflags __attribute__((unused)))
+{
+}
+
+static inline void
+cpu_barrier(void)
+{
+    __asm__ volatile ("" : : : "memory");
+}
+
+static inline void
+cpu_cli(void)
+{
+}
+
+static inline void
+cpu_hlt(void)
+{
+}
+
+static inline void
+cpu_sti_hlt(void)
+{
+}
+
+static inline uint64_t
+cpu_rdtsc(void)
+{
+    return 0;
+}
+
+static inline uint8_t
+inb(uint16_t port)
+{
+    cpu_io_count++;
+    cpu_barrier();
+
+    return cpu_fake_ports[port];
+}
+
+static inline void
+outb(uint8_t value, uint16_t port)
+{
+    cpu_io_count++;
+    cpu_fake_ports[port] = value;
+
+    // The palette is needed for screenshots
+    if (port == 0x3C8 || port == 0x3C9) {
+        cpu_fake_dac_write(port, value);
+    }
+
+    cpu_barrier();
+}
+
+static inline void
+outw(uint16_t value, uint16_t port)
+{
+    cpu_io_count++;
+    cpu_fake_ports[port] = value & 0xFF;
+    cpu_fake_ports[(uint16_t)(port + 1)] = value >> 8;
+    cpu_barrier();
+}
+
+#endif // _CPU_H_
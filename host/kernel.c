@@ -0,0 +1,399 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: kernel.c - Fake kernel for running the GUI on the host
+// --------------------------------------------------------------------------------------
+
+#include <gui.h>
+#include "host.h"
+
+enum {
+    HOST_AVAIL_MEM = 8 * 1024 * 1024,
+    HOST_VRAM_SIZE = 128 * 1024,
+    HOST_EVENT_QUEUE_SIZE = 256,
+};
+
+uint32_t cpu_io_count = 0;
+uint8_t cpu_fake_ports[0x10000];
+
+static mboot_info_st host_mboot_info;
+mboot_info_st *krn_core_mboot_info = &host_mboot_info;
+
+// Colors of the VGA palette, scaled to 8 bits
+uint8_t host_palette[256 * 3];
+static uint16_t host_palette_pos = 0;
+
+// Virtual time, which only moves when the host says so
+static uint32_t host_msecs = 0;
+static uint32_t host_deadline = 0;
+static int host_deadline_set = 0;
+
+static struct {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t seq;
+    event_st events[HOST_EVENT_QUEUE_SIZE];
+} host_events;
+
+// Keys held down by the script, updated when their events are pushed
+static uint8_t host_keys_pressed[256];
+
+// Number of events popped by the GUI so far
+uint32_t host_kernel_events_popped = 0;
+
+// Set if the GUI presented a frame before polling for events again
+static int host_frame_pending = 1;
+
+// Hooks of the simulator, see host/sim.c
+void (*host_kernel_on_frame)(void) = NULL;
+void (*host_kernel_on_idle)(void) = NULL;
+
+int
+cpu_has_cpuid(void)
+{
+    return 0;
+}
+
+void
+cpu_cpuid(uint32_t eax _unsd, uint32_t *ebx, uint32_t *ecx, uint32_t *edx)
+{
+    *ebx = *ecx = *edx = 0;
+}
+
+// Follow writes to the DAC, port 0x3C8 selects the color and 0x3C9 takes
+// its red, green and blue components in turn
+void
+cpu_fake_dac_write(uint16_t port, uint8_t value)
+{
+    if (port == 0x3C8) {
+        host_palette_pos = value * 3;
+    } else {
+        host_palette[host_palette_pos] = (value << 2) | (value >> 4);
+        host_palette_pos = (host_palette_pos + 1) % (256 * 3);
+    }
+}
+
+void
+krn_debug_printf(const char *fmt, ...)
+{
+    char buf[256];
+    va_list args;
+
+    va_start(args, fmt);
+    (void) vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    host_log(buf);
+}
+
+// The host keeps no kernel stats
+void
+krn_event_dump_stats(void)
+{
+}
+
+int
+krn_event_push(event_st event)
+{
+    return host_kernel_push_event(event);
+}
+
+size_t
+krn_event_pop_many(event_st *events, size_t max, int *more)
+{
+    size_t count = 0;
+
+    // The GUI presents a frame after handling all queued events
+    if (host_frame_pending && host_kernel_on_frame) {
+        host_kernel_on_frame();
+    }
+
+    while (count < max && host_events.tail != host_events.head) {
+        events[count++] = host_events.events[host_events.tail];
+        host_events.tail = (host_events.tail + 1) % HOST_EVENT_QUEUE_SIZE;
+    }
+
+    *more = host_events.tail != host_events.head;
+    host_frame_pending = count > 0 && !*more;
+    host_kernel_events_popped += count;
+
+    return count;
+}
+
+// Waiting jumps straight to the next tick, unless the simulator decides
+void
+krn_event_wait(void)
+{
+    if (host_kernel_on_idle) {
+        host_kernel_on_idle();
+    } else {
+        host_kernel_advance(host_msecs + 10);
+    }
+}
+
+void *
+krn_heap_alloc(size_t size)
+{
+    return host_alloc(size);
+}
+
+void
+krn_heap_free(void *ptr)
+{
+    host_free(ptr);
+}
+
+void
+krn_heap_dump_stats(void)
+{
+}
+
+int
+krn_arena_init(krn_arena_st *arena, uint32_t pages)
+{
+    arena->base = host_alloc(pages * PAGE_SIZE);
+    arena->size = arena->base ? pages * PAGE_SIZE : 0;
+    arena->used = 0;
+    arena->peak = 0;
+    arena->failures = 0;
+
+    return arena->base ? 0 : -1;
+}
+
+void *
+krn_arena_alloc(krn_arena_st *arena, size_t size)
+{
+    size = (size + 15) & ~15;
+
+    if (arena->used + size > arena->size) {
+        arena->failures++;
+        return NULL;
+    }
+
+    void *ret = arena->base + arena->used;
+    arena->used += size;
+    arena->peak = MAX(arena->peak, arena->used);
+
+    return ret;
+}
+
+void
+krn_arena_reset(krn_arena_st *arena)
+{
+    arena->used = 0;
+}
+
+int
+krn_keyboard_is_pressed(uint8_t code)
+{
+    return host_keys_pressed[code & 0x7F];
+}
+
+void
+krn_keyboard_set_repeat(uint16_t delay _unsd, uint16_t rate _unsd)
+{
+}
+
+void
+krn_rtc_get_time(time_st *t)
+{
+    *t = (time_st) {
+        .second = 0,
+        .minute = 0,
+        .hour = 12,
+        .day = 1,
+        .month = 1,
+        .year = 2026,
+    };
+}
+
+int
+krn_rtc_are_times_equal(time_st *t1, time_st *t2)
+{
+    return t1->year == t2->year &&
+        t1->month == t2->month &&
+        t1->day == t2->day &&
+        t1->hour == t2->hour &&
+        t1->minute == t2->minute &&
+        t1->second == t2->second;
+}
+
+// The host stays silent
+void
+krn_serial_flush(void)
+{
+}
+
+void
+krn_serial_dump_stats(void)
+{
+}
+
+int
+krn_speaker_queue(const krn_note_st *notes _unsd, size_t count _unsd)
+{
+    return 0;
+}
+
+void
+krn_speaker_stop(void)
+{
+}
+
+void
+krn_speaker_play(unsigned hz _unsd)
+{
+}
+
+const char *
+krn_system_get_cpu_vendor(void)
+{
+    return "Host";
+}
+
+uint32_t
+krn_system_get_avail_mem(void)
+{
+    return HOST_AVAIL_MEM;
+}
+
+uint32_t
+krn_system_get_total_mem(void)
+{
+    return HOST_AVAIL_MEM;
+}
+
+uint32_t
+krn_system_get_kernel_size(void)
+{
+    return 0;
+}
+
+int
+krn_system_has_boot_arg(const char *arg _unsd)
+{
+    return 0;
+}
+
+int
+krn_system_has_tsc(void)
+{
+    return 0;
+}
+
+// The host has no threads
+void
+krn_thread_sample_usage(void)
+{
+}
+
+int
+krn_thread_get_usage(size_t idx _unsd, krn_thread_usage_st *usage _unsd)
+{
+    return 0;
+}
+
+uint64_t
+krn_timer_get_usecs(void)
+{
+    return (uint64_t)host_msecs * 1000;
+}
+
+uint32_t
+krn_timer_get_msecs(void)
+{
+    return host_msecs;
+}
+
+void
+krn_timer_set_deadline(uint32_t msecs)
+{
+    host_deadline = msecs;
+    host_deadline_set = 1;
+}
+
+// There's no way to tell the time spent in the GUI, so it all counts as idle
+uint64_t
+krn_timer_get_idle_usecs(void)
+{
+    return krn_timer_get_usecs();
+}
+
+uint8_t
+krn_timer_get_cpu_usage(void)
+{
+    return 0;
+}
+
+// Queue an event for the GUI. Returns 0 on success, -1 if the queue is full.
+int
+host_kernel_push_event(event_st event)
+{
+    uint32_t next = (host_events.head + 1) % HOST_EVENT_QUEUE_SIZE;
+
+    if (next == host_events.tail) {
+        return -1;
+    }
+
+    if (event.type == EVENT_KEY_DOWN || event.type == EVENT_KEY_UP) {
+        host_keys_pressed[event.key_code & 0x7F] = event.type == EVENT_KEY_DOWN;
+    }
+
+    event.seq = host_events.seq++;
+    event.usecs = host_msecs * 1000;
+
+    host_events.events[host_events.head] = event;
+    host_events.head = next;
+
+    return 0;
+}
+
+// Get the time of the next timer tick requested by the GUI.
+// Returns 0 if there is none.
+int
+host_kernel_get_deadline(uint32_t *msecs)
+{
+    *msecs = host_deadline;
+    return host_deadline_set;
+}
+
+// Move the virtual time forward, ticking the timer if the deadline passed
+void
+host_kernel_advance(uint32_t msecs)
+{
+    host_msecs = msecs;
+
+    if (host_deadline_set && (int32_t)(msecs - host_deadline) >= 0) {
+        event_st event = {
+            .type = EVENT_TIMER_TICK,
+            .timer_msecs = msecs,
+        };
+
+        host_deadline_set = 0;
+        (void)host_kernel_push_event(event);
+    }
+}
+
+// Set up a fake framebuffer in the format GRUB would report
+void
+host_kernel_init(void)
+{
+    host_mboot_info.fb_width = GUI_WIDTH;
+    host_mboot_info.fb_height = GUI_HEIGHT;
+
+#if GUI_PLANAR_MODE
+    host_mboot_info.fb_pitch = GUI_WIDTH / 8;
+    host_mboot_info.fb_bpp = 1;
+    host_mboot_info.fb_addr = host_alloc(HOST_VRAM_SIZE);
+#else
+    host_mboot_info.fb_pitch = GUI_WIDTH;
+    host_mboot_info.fb_bpp = 8;
+    host_mboot_info.fb_addr = host_alloc(GUI_WIDTH * GUI_HEIGHT);
+#endif
+
+    if (!host_mboot_info.fb_addr) {
+        host_log("host: no memory for the framebuffer\n");
+        host_exit(1);
+    }
+}
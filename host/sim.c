@@ -0,0 +1,605 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: sim.c - Headless simulator running the GUI with scripted input on the host
+// --------------------------------------------------------------------------------------
+
+// Scripts have one command per line, see host/scenarios for examples:
+//
+//   wait MSECS                        let the virtual time pass
+//   move X Y, down X Y, up X Y        move or press the pointer
+//   alt X Y                           press the alternate pointer button
+//   drag X0 Y0 X1 Y1 STEPS MSECS      press, move in steps and release the pointer
+//   key CODE [CHAR], keydown CODE [CHAR], keyup CODE [CHAR]
+//   shot FILE                         write a screenshot in PPM format
+//   repeat COUNT ... end              repeat the commands in between
+
+#include <gui.h>
+#include "host.h"
+
+enum {
+    SIM_COMMANDS_MAX = 4096,
+    SIM_LOOP_DEPTH = 8,
+    SIM_PATH_LEN = 128,
+    SIM_FRAME_SIZE = GUI_WIDTH * GUI_HEIGHT,
+};
+
+enum {
+    SIM_CMD_WAIT,
+    SIM_CMD_POINTER,
+    SIM_CMD_KEY,
+    SIM_CMD_KEY_DOWN,
+    SIM_CMD_KEY_UP,
+    SIM_CMD_SHOT,
+    SIM_CMD_REPEAT,
+    SIM_CMD_END,
+};
+
+typedef struct {
+    int type;
+    int line;
+    int event_type;
+    int args[3];
+    char path[SIM_PATH_LEN];
+} sim_cmd_st;
+
+static sim_cmd_st sim_commands[SIM_COMMANDS_MAX];
+static int sim_commands_count = 0;
+
+// Position in the script, and the time when the next command runs
+static int sim_pc = 0;
+static uint32_t sim_time = 0;
+
+static struct {
+    int start;
+    int left;
+} sim_loops[SIM_LOOP_DEPTH];
+static int sim_loops_depth = 0;
+
+static int sim_quiet = 0;
+static int sim_pushed = 0;
+
+static uint8_t *sim_prev_frame;
+
+static struct {
+    uint32_t frames;
+    uint32_t events;
+    uint32_t io_count;
+    uint32_t checksum;
+    uint64_t gui_nsecs;
+    uint64_t frame_nsecs;
+    uint64_t resumed_at;
+} sim_stats;
+
+static void
+sim_fail(int line, const char *msg)
+{
+    krn_debug_printf("sim: line %d: %s\n", line, msg);
+    host_exit(1);
+}
+
+static void
+sim_printf(const char *fmt, ...)
+{
+    char buf[256];
+    va_list args;
+
+    va_start(args, fmt);
+    (void) vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    host_print(buf);
+}
+
+static uint32_t
+sim_fnv1a(uint32_t hash, const uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619;
+    }
+
+    return hash;
+}
+
+static const char *
+sim_skip_spaces(const char *s)
+{
+    while (*s == ' ' || *s == '\t' || *s == '\r') {
+        s++;
+    }
+
+    return s;
+}
+
+// Parse the next word of a line into buf. Returns the rest of the line.
+static const char *
+sim_parse_word(const char *s, char *buf, size_t size)
+{
+    size_t len = 0;
+
+    s = sim_skip_spaces(s);
+
+    while (*s && *s != '\n' && *s != ' ' && *s != '\t' && *s != '\r') {
+        if (len + 1 < size) {
+            buf[len++] = *s;
+        }
+        s++;
+    }
+
+    buf[len] = 0;
+    return s;
+}
+
+// Parse a decimal or hexadecimal number. Returns 0 on success, -1 on failure.
+static int
+sim_parse_int(const char *word, int *out)
+{
+    int base = 10, sign = 1, ret = 0;
+
+    if (*word == '-') {
+        sign = -1;
+        word++;
+    }
+
+    if (word[0] == '0' && word[1] == 'x') {
+        base = 16;
+        word += 2;
+    }
+
+    if (!*word) {
+        return -1;
+    }
+
+    for (; *word; ++word) {
+        int digit;
+
+        if (*word >= '0' && *word <= '9') {
+            digit = *word - '0';
+        } else if (base == 16 && *word >= 'a' && *word <= 'f') {
+            digit = *word - 'a' + 10;
+        } else if (base == 16 && *word >= 'A' && *word <= 'F') {
+            digit = *word - 'A' + 10;
+        } else {
+            return -1;
+        }
+
+        ret = ret * base + digit;
+    }
+
+    *out = ret * sign;
+    return 0;
+}
+
+static sim_cmd_st *
+sim_add_command(int line, int type)
+{
+    if (sim_commands_count >= SIM_COMMANDS_MAX) {
+        sim_fail(line, "too many commands");
+    }
+
+    sim_cmd_st *cmd = &sim_commands[sim_commands_count++];
+
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->type = type;
+    cmd->line = line;
+
+    return cmd;
+}
+
+static void
+sim_add_pointer(int line, int event_type, int x, int y)
+{
+    sim_cmd_st *cmd = sim_add_command(line, SIM_CMD_POINTER);
+
+    cmd->event_type = event_type;
+    cmd->args[0] = x;
+    cmd->args[1] = y;
+}
+
+static void
+sim_add_wait(int line, int msecs)
+{
+    sim_add_command(line, SIM_CMD_WAIT)->args[0] = msecs;
+}
+
+// Split a line into the command name and up to 6 arguments
+static int
+sim_split_line(const char **s, char words[7][SIM_PATH_LEN])
+{
+    int count = 0;
+
+    while (count < 7) {
+        *s = sim_parse_word(*s, words[count], SIM_PATH_LEN);
+
+        if (!words[count][0]) {
+            break;
+        }
+
+        count++;
+    }
+
+    return count;
+}
+
+static void
+sim_parse_line(int line, const char *s)
+{
+    static const struct {
+        const char *name;
+        int args;
+    } syntax[] = {
+        { "wait", 1 }, { "move", 2 }, { "down", 2 }, { "up", 2 }, { "alt", 2 },
+        { "drag", 6 }, { "key", 1 }, { "keydown", 1 }, { "keyup", 1 },
+        { "shot", 0 }, { "repeat", 1 }, { "end", 0 },
+    };
+
+    char words[7][SIM_PATH_LEN];
+    int n[6] = { 0 };
+    int count = sim_split_line(&s, words);
+    size_t i;
+
+    if (count == 0 || words[0][0] == '#') {
+        return;
+    }
+
+    for (i = 0; i < sizeof(syntax) / sizeof(syntax[0]); ++i) {
+        if (strcmp(words[0], syntax[i].name) == 0) {
+            break;
+        }
+    }
+
+    if (i == sizeof(syntax) / sizeof(syntax[0])) {
+        sim_fail(line, "unknown command");
+    }
+
+    if (count - 1 < syntax[i].args) {
+        sim_fail(line, "missing arguments");
+    }
+
+    for (int arg = 0; arg < syntax[i].args; ++arg) {
+        if (sim_parse_int(words[arg + 1], &n[arg]) != 0) {
+            sim_fail(line, "invalid number");
+        }
+    }
+
+    const char *name = words[0];
+
+    if (strcmp(name, "wait") == 0) {
+        sim_add_wait(line, n[0]);
+    } else if (strcmp(name, "move") == 0) {
+        sim_add_pointer(line, EVENT_POINTER_MOVE, n[0], n[1]);
+    } else if (strcmp(name, "down") == 0) {
+        sim_add_pointer(line, EVENT_POINTER_DOWN, n[0], n[1]);
+    } else if (strcmp(name, "up") == 0) {
+        sim_add_pointer(line, EVENT_POINTER_UP, n[0], n[1]);
+    } else if (strcmp(name, "alt") == 0) {
+        sim_add_pointer(line, EVENT_POINTER_ALT, n[0], n[1]);
+    } else if (strcmp(name, "drag") == 0) {
+        int steps = MAX(n[4], 1);
+
+        sim_add_pointer(line, EVENT_POINTER_DOWN, n[0], n[1]);
+
+        for (int step = 1; step <= steps; ++step) {
+            sim_add_wait(line, n[5] / steps);
+            sim_add_pointer(line, EVENT_POINTER_MOVE,
+                n[0] + (n[2] - n[0]) * step / steps, n[1] + (n[3] - n[1]) * step / steps);
+        }
+
+        sim_add_pointer(line, EVENT_POINTER_UP, n[2], n[3]);
+    } else if (name[0] == 'k') {
+        int type = strcmp(name, "keydown") == 0 ? SIM_CMD_KEY_DOWN :
+            strcmp(name, "keyup") == 0 ? SIM_CMD_KEY_UP : SIM_CMD_KEY;
+        sim_cmd_st *cmd = sim_add_command(line, type);
+
+        cmd->args[0] = n[0];
+
+        // The character is either given literally or as a number
+        if (count > 2 && (strlen(words[2]) == 1 || sim_parse_int(words[2], &n[1]) != 0)) {
+            cmd->args[1] = (uint8_t)words[2][0];
+        } else if (count > 2) {
+            cmd->args[1] = n[1];
+        }
+    } else if (strcmp(name, "shot") == 0) {
+        if (count < 2) {
+            sim_fail(line, "missing file name");
+        }
+
+        strncpy(sim_add_command(line, SIM_CMD_SHOT)->path, words[1], SIM_PATH_LEN - 1);
+    } else if (strcmp(name, "repeat") == 0) {
+        sim_add_command(line, SIM_CMD_REPEAT)->args[0] = n[0];
+    } else {
+        sim_add_command(line, SIM_CMD_END);
+    }
+}
+
+static void
+sim_load_script(const char *path)
+{
+    uint32_t size;
+    char *script = host_read_file(path, &size);
+    int line = 1;
+
+    if (!script) {
+        host_exit(1);
+    }
+
+    for (const char *s = script; *s; ++line) {
+        sim_parse_line(line, s);
+
+        while (*s && *s != '\n') {
+            s++;
+        }
+
+        if (*s) {
+            s++;
+        }
+    }
+
+    host_free(script);
+}
+
+// Load the default VGA palette from a GIMP palette file
+static void
+sim_load_palette(const char *path)
+{
+    uint32_t size;
+    char *gpl = host_read_file(path, &size);
+    char word[16];
+    int color = 0;
+
+    if (!gpl) {
+        host_exit(1);
+    }
+
+    for (const char *s = gpl; *s && color < 256;) {
+        int rgb[3];
+        int i;
+
+        for (i = 0; i < 3; ++i) {
+            s = sim_parse_word(s, word, sizeof(word));
+
+            if (sim_parse_int(word, &rgb[i]) != 0) {
+                break;
+            }
+        }
+
+        if (i == 3) {
+            host_palette[color * 3 + 0] = rgb[0];
+            host_palette[color * 3 + 1] = rgb[1];
+            host_palette[color * 3 + 2] = rgb[2];
+            color++;
+        }
+
+        while (*s && *s != '\n') {
+            s++;
+        }
+
+        if (*s) {
+            s++;
+        }
+    }
+
+    host_free(gpl);
+}
+
+static void
+sim_write_screenshot(int line, const char *path)
+{
+    uint8_t *pixels = gui_fb_vram_surface->pixels;
+    char header[32];
+    int header_len = snprintf(header, sizeof(header), "P6\n%d %d\n255\n",
+        GUI_WIDTH, GUI_HEIGHT);
+    uint8_t *ppm = host_alloc(header_len + SIM_FRAME_SIZE * 3);
+
+    if (!ppm) {
+        sim_fail(line, "not enough memory for the screenshot");
+    }
+
+    memcpy(ppm, header, header_len);
+
+    for (int i = 0; i < SIM_FRAME_SIZE; ++i) {
+        memcpy(ppm + header_len + i * 3, &host_palette[pixels[i] * 3], 3);
+    }
+
+    if (host_write_file(path, ppm, header_len + SIM_FRAME_SIZE * 3) != 0) {
+        sim_fail(line, "can't write the screenshot");
+    }
+
+    host_free(ppm);
+}
+
+static void
+sim_push_key(int type, sim_cmd_st *cmd)
+{
+    event_st event = {
+        .type = type,
+        .key_code = cmd->args[0],
+        .key_char = cmd->args[1],
+    };
+
+    (void)host_kernel_push_event(event);
+}
+
+// Run commands until the next wait, or until a screenshot needs the pushed
+// events to be presented first
+static void
+sim_run_commands(void)
+{
+    sim_pushed = 0;
+
+    while (sim_pc < sim_commands_count) {
+        sim_cmd_st *cmd = &sim_commands[sim_pc];
+
+        if (cmd->type == SIM_CMD_SHOT && sim_pushed) {
+            return;
+        }
+
+        sim_pc++;
+
+        if (cmd->type == SIM_CMD_WAIT) {
+            sim_time += cmd->args[0];
+            return;
+        } else if (cmd->type == SIM_CMD_POINTER) {
+            event_st event = {
+                .type = cmd->event_type,
+                .pointer_x = MIN(MAX(cmd->args[0], 0), GUI_WIDTH - 1),
+                .pointer_y = MIN(MAX(cmd->args[1], 0), GUI_HEIGHT - 1),
+            };
+
+            (void)host_kernel_push_event(event);
+            sim_pushed = 1;
+        } else if (cmd->type == SIM_CMD_KEY) {
+            sim_push_key(EVENT_KEY_DOWN, cmd);
+            sim_push_key(EVENT_KEY_UP, cmd);
+            sim_pushed = 1;
+        } else if (cmd->type == SIM_CMD_KEY_DOWN || cmd->type == SIM_CMD_KEY_UP) {
+            sim_push_key(cmd->type == SIM_CMD_KEY_DOWN ? EVENT_KEY_DOWN : EVENT_KEY_UP, cmd);
+            sim_pushed = 1;
+        } else if (cmd->type == SIM_CMD_SHOT) {
+            sim_write_screenshot(cmd->line, cmd->path);
+        } else if (cmd->type == SIM_CMD_REPEAT) {
+            if (sim_loops_depth >= SIM_LOOP_DEPTH) {
+                sim_fail(cmd->line, "too many nested loops");
+            }
+
+            sim_loops[sim_loops_depth].start = sim_pc;
+            sim_loops[sim_loops_depth].left = cmd->args[0];
+            sim_loops_depth++;
+        } else if (cmd->type == SIM_CMD_END) {
+            if (sim_loops_depth == 0) {
+                sim_fail(cmd->line, "end without repeat");
+            }
+
+            if (--sim_loops[sim_loops_depth - 1].left > 0) {
+                sim_pc = sim_loops[sim_loops_depth - 1].start;
+            } else {
+                sim_loops_depth--;
+            }
+        }
+    }
+}
+
+// Stop and restart the clock of the time spent in the GUI
+static void
+sim_pause(void)
+{
+    uint64_t elapsed = host_get_nsecs() - sim_stats.resumed_at;
+
+    sim_stats.gui_nsecs += elapsed;
+    sim_stats.frame_nsecs += elapsed;
+}
+
+static void
+sim_resume(void)
+{
+    sim_stats.resumed_at = host_get_nsecs();
+}
+
+static void
+sim_finish(void)
+{
+    uint32_t msecs = sim_stats.gui_nsecs / 1000000;
+    uint32_t fps = sim_stats.gui_nsecs ?
+        (uint64_t)sim_stats.frames * 1000000000 / sim_stats.gui_nsecs : 0;
+
+    sim_printf("sim: %u frames, %u events in %u ms of virtual time\n",
+        sim_stats.frames, host_kernel_events_popped, krn_timer_get_msecs());
+    sim_printf("sim: %u.%03u ms in the GUI, %u frames/sec\n",
+        msecs, (uint32_t)(sim_stats.gui_nsecs / 1000 % 1000), fps);
+    sim_printf("sim: checksum %08x\n", sim_stats.checksum);
+
+    host_exit(0);
+}
+
+static void
+sim_on_frame(void)
+{
+    uint8_t *pixels = gui_fb_vram_surface->pixels;
+    uint32_t changed = 0;
+
+    sim_pause();
+
+    for (int i = 0; i < SIM_FRAME_SIZE; ++i) {
+        changed += pixels[i] != sim_prev_frame[i];
+    }
+
+    uint32_t checksum = sim_fnv1a(2166136261U, pixels, SIM_FRAME_SIZE);
+    sim_stats.checksum = sim_fnv1a(sim_stats.checksum, (uint8_t *)&checksum, 4);
+
+    if (!sim_quiet) {
+        sim_printf("frame %u: time: %u ms, events: %u, changed: %u px, io: %u, "
+            "checksum: %08x, took: %u us\n", sim_stats.frames, krn_timer_get_msecs(),
+            host_kernel_events_popped - sim_stats.events, changed,
+            cpu_io_count - sim_stats.io_count, checksum,
+            (uint32_t)(sim_stats.frame_nsecs / 1000));
+    }
+
+    memcpy(sim_prev_frame, pixels, SIM_FRAME_SIZE);
+
+    sim_stats.frames++;
+    sim_stats.events = host_kernel_events_popped;
+    sim_stats.io_count = cpu_io_count;
+    sim_stats.frame_nsecs = 0;
+
+    sim_resume();
+}
+
+// Called when the GUI has nothing to do, moves the virtual time to whatever comes
+// first, the next timeout or the next command of the script
+static void
+sim_on_idle(void)
+{
+    uint32_t now = krn_timer_get_msecs();
+    uint32_t deadline;
+
+    sim_pause();
+
+    if (host_kernel_get_deadline(&deadline) && (int32_t)(deadline - sim_time) < 0) {
+        host_kernel_advance((int32_t)(deadline - now) > 0 ? deadline : now);
+    } else if (sim_pc < sim_commands_count) {
+        host_kernel_advance(sim_time);
+        sim_run_commands();
+    } else {
+        sim_finish();
+    }
+
+    sim_resume();
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *palette = "misc/vga-256.gpl";
+    const char *script = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-q") == 0) {
+            sim_quiet = 1;
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            palette = argv[++i];
+        } else {
+            script = argv[i];
+        }
+    }
+
+    if (!script) {
+        host_log("usage: sim [-q] [-p palette.gpl] script\n");
+        return 1;
+    }
+
+    host_kernel_init();
+    sim_load_palette(palette);
+    sim_load_script(script);
+
+    sim_prev_frame = host_alloc(SIM_FRAME_SIZE);
+    sim_stats.checksum = 2166136261U;
+
+    host_kernel_on_frame = sim_on_frame;
+    host_kernel_on_idle = sim_on_idle;
+
+    sim_resume();
+    gui_main();
+
+    return 0;
+}
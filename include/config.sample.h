@@ -6,3 +6,36 @@
 // Setting this to 1 enforces 4-bit planar mode
 // It may also require adding insmod all_video in grub.cfg
 #define GUI_PLANAR_MODE 0
+
+// Sizes of the event queues of each input source
+// Key presses are only dropped when the queue is full of unread ones, so it should
+// be large enough to hold all keys pressed while the GUI is busy
+#define EVENT_KEYBOARD_QUEUE_SIZE 64
+#define EVENT_POINTER_QUEUE_SIZE 32
+#define EVENT_TIMER_QUEUE_SIZE 4
+
+// Program the timer to interrupt only when a timeout is due, instead of 100 times
+// per second. Saves power and wakeups when idle, see kernel/timer.c
+#define TIMER_TICKLESS 0
+
+// Time after which a thread gives up the CPU to other ready threads of the same
+// priority, see kernel/thread.c
+#define THREAD_SLICE_MSECS 20
+
+// Sampling profiler, started and stopped with Ctrl+Alt+P, see kernel/profile.c
+// The timer interrupts PROFILE_HZ times per second while profiling. Every sample
+// can also record PROFILE_CALLERS return addresses, which requires building with
+// make EXTRA_CFLAGS=-fno-omit-frame-pointer
+#define PROFILE_HZ 1000
+#define PROFILE_CALLERS 0
+
+// Copy the debug output, including the dumps of the profiler and the tracers,
+// to COM1 at SERIAL_BAUD, see kernel/serial.c. Threads wait for room in
+// the transmit buffer, while interrupt handlers drop the bytes which don't fit.
+#define SERIAL_DEBUG 1
+#define SERIAL_BAUD 115200
+#define SERIAL_TX_BUFFER_SIZE 16384
+
+// Record binary trace events, like the pushes and pops of the event queues,
+// and write them to the debug port when idle, see kernel/trace.c
+#define TRACE_EVENTS 0
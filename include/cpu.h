@@ -0,0 +1,98 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: cpu.h - Inline CPU-related primitives
+// --------------------------------------------------------------------------------------
+
+#ifndef _CPU_H_
+#define _CPU_H_
+
+#include <stdint.h>
+
+// Number of port I/O operations since boot, see lib/cpu.s
+extern uint32_t cpu_io_count;
+
+static inline uint32_t
+cpu_get_eflags(void)
+{
+    uint32_t eflags;
+
+    __asm__ volatile ("pushfl; popl %0" : "=r" (eflags));
+
+    return eflags;
+}
+
+static inline void
+cpu_set_eflags(uint32_t eflags)
+{
+    __asm__ volatile ("pushl %0; popfl" : : "g" (eflags) : "memory", "cc");
+}
+
+// Prevent the compiler from moving memory accesses across this point
+static inline void
+cpu_barrier(void)
+{
+    __asm__ volatile ("" : : : "memory");
+}
+
+static inline void
+cpu_cli(void)
+{
+    __asm__ volatile ("cli" : : : "memory");
+}
+
+static inline void
+cpu_hlt(void)
+{
+    __asm__ volatile ("hlt" : : : "memory");
+}
+
+// Enable interrupts and halt until the next one. Interrupts are only
+// recognized after hlt, so one can't sneak in between the two.
+static inline void
+cpu_sti_hlt(void)
+{
+    __asm__ volatile ("sti; hlt" : : : "memory");
+}
+
+// Read the time stamp counter, only available if cpuid reports it
+static inline uint64_t
+cpu_rdtsc(void)
+{
+    uint64_t ret;
+
+    __asm__ volatile ("rdtsc" : "=A" (ret));
+
+    return ret;
+}
+
+// Port I/O clobbers memory, so that the compiler doesn't move
+// framebuffer writes across changes of the VGA registers
+
+static inline uint8_t
+inb(uint16_t port)
+{
+    uint8_t value;
+
+    cpu_io_count++;
+    __asm__ volatile ("inb %1, %0" : "=a" (value) : "Nd" (port) : "memory");
+
+    return value;
+}
+
+static inline void
+outb(uint8_t value, uint16_t port)
+{
+    cpu_io_count++;
+    __asm__ volatile ("outb %0, %1" : : "a" (value), "Nd" (port) : "memory");
+}
+
+static inline void
+outw(uint16_t value, uint16_t port)
+{
+    cpu_io_count++;
+    __asm__ volatile ("outw %0, %1" : : "a" (value), "Nd" (port) : "memory");
+}
+
+#endif // _CPU_H_
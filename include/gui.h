@@ -59,6 +59,10 @@ typedef struct {
     size_st size;
     int pitch;
     uint8_t *pixels;
+
+    // Packed copy of pixels of an unloaded surface, see gui/pool.c
+    uint8_t *packed;
+    size_t packed_size;
 } surface_st;
 
 enum {
@@ -119,6 +123,7 @@ struct window {
     void (*on_key_down)(window_st *, event_st event);
     void (*on_key_up)(window_st *, event_st event);
     void (*on_active_change)(window_st *);
+    void (*on_time_change)(window_st *, event_st event);
 };
 
 typedef struct {
@@ -158,6 +163,7 @@ enum {
     KEY_DOWN = 0x50,
     KEY_LEFT = 0x4b,
     KEY_RIGHT = 0x4d,
+    KEY_SPACE = 0x39,
 };
 
 enum {
@@ -22,6 +22,11 @@ typedef struct {
 
     uint32_t int_no;
     uint32_t error;
+
+    // Pushed by the CPU, without ESP and SS as the kernel runs in a single ring
+    uint32_t eip;
+    uint32_t cs;
+    uint32_t eflags;
 } __attribute__((packed)) isr_stack_st;
 
 typedef void (*isr_handler_fn)(isr_stack_st *isr_stack);
@@ -36,25 +41,50 @@ typedef struct {
 typedef struct {
     uint32_t flags;
 
-    uint32_t unused_1[10];
+    uint32_t unused_1[3];
+
+    const char *cmdline;
+
+    uint32_t unused_2[6];
 
     uint32_t mmap_length;
     mboot_mmap_entry_st *mmap_addr;
 
-    uint32_t unused_2[3];
+    uint32_t unused_3[3];
 
     const char *boot_loader_name;
 
-    uint32_t unused_3[5];
+    uint32_t unused_4[5];
 
     uint8_t *fb_addr;
-    uint32_t unused_4;
+    uint32_t unused_5;
     uint32_t fb_pitch;
     uint32_t fb_width;
     uint32_t fb_height;
     uint8_t fb_bpp;
 } __attribute__ ((packed)) mboot_info_st;
 
+enum {
+    PAGE_SIZE = 4096,
+};
+
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t used;
+    size_t peak;
+    uint32_t failures;
+} krn_arena_st;
+
+typedef struct {
+    uint16_t hz;
+    uint16_t msecs;
+} krn_note_st;
+
+// Queue a static array of notes, see kernel/speaker.c
+#define KRN_SPEAKER_QUEUE(notes) \
+    (void)krn_speaker_queue((notes), sizeof(notes) / sizeof((notes)[0]))
+
 typedef struct {
     uint8_t second;
     uint8_t minute;
@@ -64,6 +94,44 @@ typedef struct {
     uint16_t year;
 } time_st;
 
+// Priorities of the threads, see kernel/thread.c
+enum {
+    THREAD_PRIORITY_IDLE = 0,
+    THREAD_PRIORITY_LOW = 1,
+    THREAD_PRIORITY_NORMAL = 2,
+    THREAD_PRIORITY_HIGH = 3,
+};
+
+typedef void (*thread_fn)(void *arg);
+
+typedef struct {
+    const char *name;
+    uint8_t priority;
+    uint8_t usage;      // Percent of the CPU used between the last two samples
+    uint32_t msecs;     // Total CPU time, as of the last sample
+} krn_thread_usage_st;
+
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS 0
+#endif
+
+// Ids of the binary trace events, see kernel/trace.c. The comments are
+// the formats of their arguments, used by misc/trace-events.py.
+enum {
+    TRACE_EVENT_PUSHED = 1,     // event pushed: lane=%u type=%u data=%08x
+    TRACE_EVENT_COALESCED = 2,  // event coalesced: lane=%u type=%u data=%08x
+    TRACE_EVENT_OVERFLOW = 3,   // event overflow: lane=%u type=%u data=%08x
+    TRACE_EVENT_POPPED = 4,     // event popped: lane=%u type=%u data=%08x
+};
+
+// Record a trace event, compiled out unless TRACE_EVENTS is set
+#define KRN_TRACE(id, arg0, arg1, arg2)                             \
+    do {                                                            \
+        if (TRACE_EVENTS) {                                         \
+            krn_trace_event((id), (arg0), (arg1), (arg2));          \
+        }                                                           \
+    } while (0)
+
 enum {
     EVENT_UNKNOWN = 0,
     EVENT_POINTER_MOVE = 1,
@@ -73,10 +141,28 @@ enum {
     EVENT_KEY_DOWN = 5,
     EVENT_KEY_UP = 6,
     EVENT_TIMER_TICK = 7,
+    EVENT_TIME_CHANGE = 8,
+    EVENT_HOTKEY = 9,
+};
+
+enum {
+    KEY_FLAG_EXTENDED = 0x01, // Key code was prefixed with 0xE0
+    KEY_FLAG_REPEAT = 0x02,   // Key is held down, generated by auto-repeat
+};
+
+// Key codes of the hotkeys pressed with Ctrl+Alt, see kernel/keyboard.c. The ones
+// handled by the GUI are pushed as EVENT_HOTKEY.
+enum {
+    HOTKEY_TRACE = 0x14,    // T
+    HOTKEY_OVERLAY = 0x18,  // O
+    HOTKEY_PROFILE = 0x19,  // P
+    HOTKEY_REBOOT = 0x53,   // Del
 };
 
 typedef struct {
     uint8_t type;
+    uint32_t seq;
+    uint32_t usecs;
     union {
         struct {
             uint16_t pointer_x;
@@ -85,6 +171,7 @@ typedef struct {
         struct {
             uint8_t key_code;
             uint8_t key_char;
+            uint8_t key_flags;
         };
         struct {
             uint32_t timer_msecs;
@@ -95,6 +182,9 @@ typedef struct {
 extern void *krn_link_start;
 extern void *krn_link_end;
 
+extern void *krn_core_stack;
+extern void *krn_core_stack_end;
+
 #include "proto_kernel.h"
 
 #endif // _KERNEL_H_
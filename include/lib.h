@@ -12,6 +12,7 @@
 #include <stdint.h>
 
 #include <config.h>
+#include <cpu.h>
 
 #define NULL ((void *)0)
 
@@ -27,17 +28,11 @@
     }                                   \
     _already_called = 1;
 
-typedef uint32_t size_t;
+// Same as uint32_t on the target, but also matches the C library when built for the host
+typedef __SIZE_TYPE__ size_t;
 typedef int32_t ssize_t;
 
 // lib/cpu.s
-uint32_t cpu_get_eflags(void);
-void cpu_set_eflags(uint32_t eflags);
-void cpu_cli(void);
-void cpu_hlt(void);
-uint8_t inb(uint16_t port);
-void outb(uint8_t value, uint16_t port);
-void outw(uint16_t value, uint16_t port);
 int cpu_has_cpuid(void);
 void cpu_cpuid(uint32_t eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx);
 
@@ -1,5 +1,7 @@
 /* apps/about.c */
 extern app_st app_about;
+/* apps/bench.c */
+extern app_st app_bench;
 /* apps/blackjack.c */
 extern app_st app_blackjack;
 /* apps/calc.c */
@@ -14,6 +16,8 @@ extern app_st app_colors;
 extern app_st app_fonts;
 /* apps/mines.c */
 extern app_st app_mines;
+/* apps/monitor.c */
+extern app_st app_monitor;
 /* apps/pairs.c */
 extern app_st app_pairs;
 /* apps/panel.c */
@@ -1,5 +1,6 @@
 /* data/data_bitmaps.c */
 extern bitmap_st bitmap_icon_about;
+extern bitmap_st bitmap_icon_bench;
 extern bitmap_st bitmap_icon_blackjack;
 extern bitmap_st bitmap_icon_calc;
 extern bitmap_st bitmap_icon_calendar;
@@ -8,6 +9,7 @@ extern bitmap_st bitmap_icon_colors;
 extern bitmap_st bitmap_icon_fonts;
 extern bitmap_st bitmap_icon_github;
 extern bitmap_st bitmap_icon_mines;
+extern bitmap_st bitmap_icon_monitor;
 extern bitmap_st bitmap_icon_pairs;
 extern bitmap_st bitmap_icon_pairs_bear;
 extern bitmap_st bitmap_icon_pairs_bot;
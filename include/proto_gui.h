@@ -1,3 +1,6 @@
+/* gui/benchmark.c */
+extern int gui_benchmark_on_idle(void);
+extern void gui_benchmark_init(void);
 /* gui/button.c */
 extern void gui_button_on_pointer_down(widget_st *widget, event_st event, point_st pos);
 extern void gui_button_on_pointer_up(widget_st *widget, event_st event, point_st pos);
@@ -13,12 +16,19 @@ extern void gui_drag_draw_outline(void);
 extern void gui_drag_clear_outline(void);
 /* gui/fb.c */
 extern surface_st *gui_fb_vram_surface;
+extern uint32_t gui_fb_frames;
+extern uint32_t gui_fb_dirty_pixels;
+extern uint32_t gui_fb_flushed_bytes;
 extern void gui_fb_draw_start(void);
 extern void gui_fb_draw_end(void);
 extern void gui_fb_mark_dirty(rect_st rect);
 extern void gui_fb_draw_rect(rect_st rect, uint8_t color);
 extern void gui_fb_draw_pattern(rect_st rect, bitmap_st *pattern, uint8_t c1, uint8_t c2);
 extern void gui_fb_draw_surface(int dst_x, int dst_y, surface_st *src_sf, rect_st src_rect);
+extern void gui_fb_draw_char(int x, int y, font_st *font, uint8_t ch, uint8_t fg, uint8_t bg);
+extern void gui_fb_draw_str(int x, int y, font_st *font, const char *s, uint8_t fg, uint8_t bg);
+extern void gui_fb_draw_overlay_rect(rect_st rect, uint8_t color);
+extern void gui_fb_draw_overlay_str(int x, int y, const char *s, uint8_t fg, uint8_t bg);
 extern void gui_fb_draw_outline(rect_st rect);
 extern void gui_fb_flush(void);
 extern void gui_fb_init(void);
@@ -26,19 +36,41 @@ extern void gui_fb_init(void);
 extern rect_st gui_grid_rect(grid_st *grid);
 extern rect_st gui_grid_cell_rect(grid_st *grid, int col, int row);
 extern void gui_grid_draw_background(grid_st *grid, window_st *window, uint8_t color);
+/* gui/latency.c */
+extern void gui_latency_begin(event_st *event);
+extern void gui_latency_end(void);
+extern void gui_latency_on_damage(void);
+extern void gui_latency_on_present(void);
+extern void gui_latency_dump(void);
+extern void gui_latency_init(void);
 /* gui/main.c */
+extern krn_arena_st gui_frame_arena;
+extern uint32_t gui_events_handled;
 extern void gui_main(void);
+/* gui/overlay.c */
+extern void gui_overlay_on_damage(rect_st rect);
+extern void gui_overlay_on_composite(void);
+extern rect_st gui_overlay_draw(rect_st flushed);
+extern void gui_overlay_toggle(void);
 /* gui/planar.c */
 extern void gui_planar_flush(rect_st rect);
 extern void gui_planar_draw_rect(rect_st rect, uint8_t color);
 extern void gui_planar_draw_pattern(rect_st dst_rect, bitmap_st *pattern, uint8_t c1, uint8_t c2);
 extern void gui_planar_draw_surface(int dst_x, int dst_y, surface_st *src, rect_st src_rect);
+extern void gui_planar_draw_char(int x, int y, font_st *font, uint8_t ch, uint8_t fg, uint8_t bg);
+extern void gui_planar_draw_str(int x, int y, font_st *font, const char *s, uint8_t fg, uint8_t bg);
 extern void gui_planar_draw_pointer(int dst_x, int dst_y);
 extern void gui_planar_xor_corners(rect_st rect);
 /* gui/pointer.c */
 extern void gui_pointer_draw(void);
 extern void gui_pointer_move(uint16_t x, uint16_t y);
 extern void gui_pointer_init(void);
+/* gui/pool.c */
+extern int gui_pool_load_surface(surface_st *surface, const char *name, int width, int height);
+extern void gui_pool_unload_surface(surface_st *surface);
+extern size_t gui_pool_get_used(void);
+extern size_t gui_pool_get_free(void);
+extern int gui_pool_get_usage(size_t idx, const char **name, size_t *bytes);
 /* gui/rect.c */
 extern int gui_rect_is_empty(rect_st r);
 extern rect_st gui_rect_make(int x, int y, int width, int height);
@@ -58,6 +90,7 @@ extern void gui_status_set_alert(const char *fmt, ...);
 extern void gui_status_init(void);
 /* gui/surface.c */
 extern void gui_surface_copy(surface_st *dst_sf, int dst_x, int dst_y, surface_st *src_sf, rect_st src_rect);
+extern void gui_surface_scroll(surface_st *surface, rect_st rect, int dx);
 extern void gui_surface_draw_h_seg(surface_st *surface, int x, int y, int w, uint8_t color);
 extern void gui_surface_draw_v_seg(surface_st *surface, int x, int y, int h, uint8_t color);
 extern void gui_surface_draw_border(surface_st *surface, rect_st r, uint8_t color);
@@ -71,11 +104,20 @@ extern void gui_surface_draw_pattern(surface_st *surface, rect_st reg, bitmap_st
 /* gui/timeout.c */
 extern void gui_timeout_remove(uint64_t id);
 extern int gui_timeout_add(uint32_t msecs, timeout_callback_fn callback, timeout_payload payload);
+extern int gui_timeout_add_periodic(uint32_t msecs, timeout_callback_fn callback, timeout_payload payload);
 extern void gui_timeout_on_tick(event_st event);
+extern void gui_timeout_set_deadline(void);
+extern void gui_timeout_dump_stats(void);
+extern uint32_t gui_timeout_take_late_max(void);
 /* gui/title_bar.c */
 extern void gui_title_bar_init(widget_st *bar, window_st *window);
 /* gui/vga.c */
+extern uint8_t gui_vga_seq_shadow[8];
+extern uint8_t gui_vga_gc_shadow[16];
+extern uint32_t gui_vga_reg_writes;
+extern uint32_t gui_vga_reg_skips;
 extern void gui_vga_set_color(int index, uint32_t rgb);
+extern void gui_vga_dump_stats(void);
 extern void gui_vga_init(void);
 /* gui/widget.c */
 extern void gui_widget_draw(widget_st *widget);
@@ -101,8 +143,10 @@ extern int gui_wm_add_window(struct window *w);
 extern void gui_wm_remove_window(struct window *w);
 extern void gui_wm_render_window_surface(window_st *window, rect_st desktop_reg);
 extern void gui_wm_render_desktop_region(rect_st rect, window_st *bottom_window);
+extern void gui_wm_render_screen_region(rect_st rect);
 extern void gui_wm_render_window_region(window_st *window, rect_st window_reg);
 extern window_st *gui_wm_find_window(uint16_t x, uint16_t y);
+extern void gui_wm_on_time_change(event_st event);
 extern window_st *gui_wm_top_window(void);
 extern void gui_wm_set_panel_window(window_st *w);
 extern void gui_wm_set_status_window(window_st *w);
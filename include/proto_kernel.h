@@ -2,39 +2,108 @@
 extern uint32_t krn_core_mboot_header[];
 extern mboot_info_st *krn_core_mboot_info;
 extern void krn_core_c_main(void);
-extern void krn_core_c_isr_handle(isr_stack_st *isr_stack);
+extern isr_stack_st *krn_core_c_isr_handle(isr_stack_st *isr_stack);
 /* kernel/debug.c */
+extern void krn_debug_write(const void *buf, size_t len);
 extern void krn_debug_printf(const char *fmt, ...);
 extern void krn_debug_beep(unsigned hz, unsigned msecs, unsigned count);
 extern void krn_debug_dump_multiboot_info(void);
 extern void krn_debug_dump_kernel_location(void);
+extern void krn_debug_dump_wakeup(void);
+extern void krn_debug_init(void);
 /* kernel/event.c */
 extern int krn_event_ipush(event_st event);
 extern int krn_event_push(event_st event);
 extern int krn_event_pop(event_st *event);
+extern size_t krn_event_pop_many(event_st *events, size_t max, int *more);
 extern uint16_t krn_event_count(void);
+extern void krn_event_wait(void);
+extern void krn_event_dump_stats(void);
+/* kernel/heap.c */
+extern void *krn_heap_alloc(size_t size);
+extern void krn_heap_free(void *ptr);
+extern void krn_heap_dump_stats(void);
+extern int krn_arena_init(krn_arena_st *arena, uint32_t pages);
+extern void *krn_arena_alloc(krn_arena_st *arena, size_t size);
+extern void krn_arena_reset(krn_arena_st *arena);
 /* kernel/interrupt.c */
-extern void krn_interrupt_handle(isr_stack_st *isr_stack);
+extern isr_stack_st *krn_interrupt_handle(isr_stack_st *isr_stack);
+extern int krn_interrupt_is_active(void);
 extern void krn_interrupt_set_handler(uint8_t int_no, isr_handler_fn handler);
 /* kernel/keyboard.c */
+extern void krn_keyboard_on_tick(uint32_t msecs);
+extern int krn_keyboard_get_deadline(uint32_t *msecs);
+extern int krn_keyboard_is_pressed(uint8_t code);
+extern void krn_keyboard_set_repeat(uint16_t delay, uint16_t rate);
 extern void krn_keyboard_init(void);
 /* kernel/main.c */
 extern void krn_main(void);
 /* kernel/mouse.c */
 extern void krn_mouse_init(void);
+/* kernel/page.c */
+extern void *krn_page_alloc(uint32_t count);
+extern void krn_page_free(void *addr, uint32_t count);
+extern uint32_t krn_page_get_free_count(void);
+extern uint32_t krn_page_get_total_count(void);
+extern void krn_page_dump_stats(void);
+extern void krn_page_init(void);
+/* kernel/profile.c */
+extern void krn_profile_on_tick(isr_stack_st *isr_stack);
+extern void krn_profile_start(void);
+extern void krn_profile_stop(void);
+extern void krn_profile_toggle(void);
+extern void krn_profile_dump(void);
 /* kernel/rtc.c */
 extern int krn_rtc_are_times_equal(time_st *t1, time_st *t2);
 extern void krn_rtc_get_time(time_st *t);
+extern void krn_rtc_init(void);
+/* kernel/serial.c */
+extern size_t krn_serial_write(const void *buf, size_t len);
+extern void krn_serial_flush(void);
+extern void krn_serial_dump_stats(void);
+extern void krn_serial_init(void);
 /* kernel/speaker.c */
+extern void krn_speaker_on_tick(uint32_t msecs);
+extern int krn_speaker_get_deadline(uint32_t *msecs);
+extern int krn_speaker_queue(const krn_note_st *notes, size_t count);
+extern void krn_speaker_cancel(void);
+extern int krn_speaker_is_busy(void);
 extern void krn_speaker_stop(void);
 extern void krn_speaker_play(unsigned hz);
 /* kernel/system.c */
 extern const char *krn_system_get_cpu_vendor(void);
+extern int krn_system_has_tsc(void);
 extern uint32_t krn_system_get_total_mem(void);
-extern uint32_t krn_system_get_used_mem(void);
+extern uint32_t krn_system_get_kernel_size(void);
 extern uint32_t krn_system_get_avail_mem(void);
+extern int krn_system_has_boot_arg(const char *arg);
+/* kernel/thread.c */
+extern isr_stack_st *krn_thread_schedule(isr_stack_st *isr_stack);
+extern void krn_thread_yield(void);
+extern void krn_thread_on_tick(uint32_t msecs);
+extern int krn_thread_get_deadline(uint32_t *msecs);
+extern void krn_thread_wait(const void *channel);
+extern void krn_thread_wakeup(const void *channel);
+extern void krn_thread_sleep(uint32_t msecs);
+extern int krn_thread_create(const char *name, uint8_t priority, thread_fn fn, void *arg);
+extern void krn_thread_get_stack(uint32_t *start, uint32_t *end);
+extern uint64_t krn_thread_get_idle_cycles(void);
+extern void krn_thread_sample_usage(void);
+extern int krn_thread_get_usage(size_t idx, krn_thread_usage_st *usage);
+extern void krn_thread_init(const char *name, uint8_t priority);
 /* kernel/timer.c */
-extern volatile uint8_t krn_timer_is_cpu_idle;
+extern uint64_t krn_timer_get_cycles(void);
+extern uint64_t krn_timer_cycles_to_usecs(uint64_t cycles);
+extern uint64_t krn_timer_get_usecs(void);
 extern uint32_t krn_timer_get_msecs(void);
+extern void krn_timer_set_deadline(uint32_t msecs);
+extern void krn_timer_reschedule(void);
+extern void krn_timer_set_sample_rate(unsigned hz);
+extern uint64_t krn_timer_get_idle_usecs(void);
 extern uint8_t krn_timer_get_cpu_usage(void);
 extern void krn_timer_init(void);
+/* kernel/trace.c */
+extern void krn_trace_toggle(void);
+extern void krn_trace_dump(void);
+extern void krn_trace_event(uint16_t id, uint32_t arg0, uint32_t arg1, uint32_t arg2);
+extern void krn_trace_drain(void);
@@ -8,6 +8,7 @@ extern uint32_t rand(void);
 extern void sleep(uint32_t msecs);
 /* lib/string.c */
 extern void *memcpy(void *dest, const void *src, size_t n);
+extern void *memmove(void *dest, const void *src, size_t n);
 extern void *memset(void *dest, int c, size_t n);
 extern int32_t strcmp(const char *s1, const char *s2);
 extern size_t strlen(const char *s1);
@@ -52,6 +52,7 @@ krn_core_entry:
 ; Empty space for the stack
 ;
 align 16
+global krn_core_stack:data
 krn_core_stack:
   resb 0x10000
 global krn_core_stack_end:data
@@ -279,10 +280,11 @@ krn_core_isr_%1:
     ; Preserve general-purpose registers
     pusha
 
-    ; Call interrupt handler in C
+    ; Call interrupt handler in C, which returns the stack to continue with,
+    ; of another thread when switching threads (see kernel/thread.c)
     push esp
     call krn_core_c_isr_handle
-    add esp, 4
+    mov esp, eax
 
     ; If interrupt comes from PIC 1, send end-of-interrupt to PIC 1
     %if %1 >= 0x20 && %1 < 0x28
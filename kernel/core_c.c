@@ -40,9 +40,9 @@ krn_core_c_main(void)
     while (1);
 }
 
-__attribute__((force_align_arg_pointer)) void
+__attribute__((force_align_arg_pointer)) isr_stack_st *
 krn_core_c_isr_handle(isr_stack_st *isr_stack)
 {
-    krn_interrupt_handle(isr_stack);
+    return krn_interrupt_handle(isr_stack);
 }
 
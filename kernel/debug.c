@@ -7,11 +7,97 @@
 
 #include <kernel.h>
 
+// Copy the debug output to COM1, which also works on real hardware
+#ifndef SERIAL_DEBUG
+#define SERIAL_DEBUG 1
+#endif
+
+enum {
+    // Longest line printed at once, formatted on the stack of the caller
+    DEBUG_LINE_SIZE = 512,
+
+    EFLAGS_IF = 0x200,
+};
+
+// Held by the thread writing to the debug port, so that the output of threads
+// doesn't interleave. Writing takes long, especially when waiting for the serial
+// port, so threads take turns with the lock instead of disabling interrupts.
+static uint8_t debug_locked = 0;
+static uint8_t debug_waiting = 0;
+
+// Cleared by krn_debug_dump_wakeup, when there may be something new to dump
+static uint8_t debug_dump_idle = 0;
+
+// Take the lock, unless called from an interrupt handler or with interrupts
+// disabled, which can't wait for it. Returns whether the lock was taken.
+static int
+krn_debug_lock(void)
+{
+    uint32_t eflags = cpu_get_eflags();
+
+    if (!(eflags & EFLAGS_IF) || krn_interrupt_is_active()) {
+        return 0;
+    }
+
+    cpu_cli();
+
+    while (debug_locked) {
+        debug_waiting = 1;
+        krn_thread_wait(&debug_locked);
+    }
+
+    debug_locked = 1;
+
+    cpu_set_eflags(eflags);
+
+    return 1;
+}
+
+static void
+krn_debug_unlock(void)
+{
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    debug_locked = 0;
+
+    if (debug_waiting) {
+        debug_waiting = 0;
+        krn_thread_wakeup(&debug_locked);
+    }
+
+    cpu_set_eflags(eflags);
+}
+
+// Write raw bytes to the debug port, and to the serial port with SERIAL_DEBUG,
+// from any context. Bytes written by interrupt handlers may end up in the middle
+// of the output of a thread.
+void
+krn_debug_write(const void *buf, size_t len)
+{
+    const uint8_t *bytes = buf;
+    int locked = krn_debug_lock();
+
+    for (size_t i = 0; i < len; i++) {
+        outb(bytes[i], 0xe9);
+    }
+
+    if (SERIAL_DEBUG) {
+        (void)krn_serial_write(buf, len);
+    }
+
+    if (locked) {
+        krn_debug_unlock();
+    }
+}
+
+// Print to the debug port, from any context, see krn_debug_write. Lines longer
+// than DEBUG_LINE_SIZE are cut.
 void
 krn_debug_printf(const char *fmt, ...)
 {
     int count;
-    static char buf[4096];
+    char buf[DEBUG_LINE_SIZE];
 
     va_list args;
 
@@ -19,19 +105,22 @@ krn_debug_printf(const char *fmt, ...)
     count = vsnprintf(buf, sizeof(buf), fmt, args);
     va_end(args);
 
-    for (int i = 0; i < count; i++) {
-        outb(buf[i], 0xe9);
+    if (count > 0) {
+        krn_debug_write(buf, MIN((size_t)count, sizeof(buf) - 1));
     }
 }
 
+// Queue count beeps, each followed by a pause of the same length
 void
 krn_debug_beep(unsigned hz, unsigned msecs, unsigned count)
 {
+    krn_note_st notes[2] = {
+        { .hz = hz, .msecs = msecs },
+        { .hz = 0, .msecs = msecs },
+    };
+
     for (unsigned i = 0; i < count; i++) {
-        krn_speaker_play(hz);
-        sleep(msecs);
-        krn_speaker_stop();
-        sleep(msecs);
+        (void)krn_speaker_queue(notes, 2);
     }
 }
 
@@ -65,6 +154,7 @@ krn_debug_dump_multiboot_info(void)
 
     if (m->flags & 0x04) {
         krn_debug_printf("bootloader: %s\n", m->boot_loader_name);
+        krn_debug_printf("cmdline: %s\n", m->cmdline);
     }
 
     if (m->flags & 0x800) {
@@ -89,3 +179,48 @@ krn_debug_dump_kernel_location(void)
 
     krn_debug_printf("kernel location: %08x - %08x (%dKB)\n", start, end, size);
 }
+
+// Wake up the dump thread, from any context. Called when the profiler or the
+// function tracer stops, and when a trace event is recorded.
+void
+krn_debug_dump_wakeup(void)
+{
+    if (debug_dump_idle) {
+        debug_dump_idle = 0;
+        krn_thread_wakeup(&debug_dump_idle);
+    }
+}
+
+// Dump the samples and the traces in a thread of low priority, since writing them
+// takes long enough to delay the GUI, which preempts the thread instead. Only the
+// dumps run here. The apps, including their slow parts like the game ticks or
+// the flood fill of Mines, run on the GUI thread, which isn't reentrant.
+static void
+krn_debug_dump_main(void *unused _unsd)
+{
+    while (1) {
+        // Set before dumping, so that a wakeup while dumping isn't lost
+        debug_dump_idle = 1;
+
+        krn_profile_dump();
+        krn_trace_dump();
+        krn_trace_drain();
+
+        uint32_t eflags = cpu_get_eflags();
+        cpu_cli();
+
+        if (debug_dump_idle) {
+            krn_thread_wait(&debug_dump_idle);
+        }
+
+        cpu_set_eflags(eflags);
+    }
+}
+
+void
+krn_debug_init(void)
+{
+    if (krn_thread_create("debug", THREAD_PRIORITY_LOW, krn_debug_dump_main, NULL) != 0) {
+        krn_debug_printf("debug: no memory for the dump thread\n");
+    }
+}
@@ -2,117 +2,220 @@
 // Copyright (c) 2026 luke8086
 // Distributed under the terms of GPL-2 License
 // --------------------------------------------------------------------------------------
-// File: event.c - Main event queue
+// File: event.c - Event queues of the input sources
 // --------------------------------------------------------------------------------------
 
 #include <kernel.h>
 
+// Every kind of events has its own queue, read only by the GUI. The queues are
+// written by interrupt handlers, which don't nest: the timer lane by IRQ0 and by
+// the RTC on IRQ8, the keyboard lane by IRQ1 and by the auto-repeat of the timer.
+// Writing from threads goes through krn_event_push, which disables interrupts,
+// so at any time a queue has a single writer and a single reader, and neither
+// of them needs to disable interrupts otherwise.
+//
+// Pointer moves and timer ticks are coalesced when the GUI falls behind. The KEY_UP
+// of a queued KEY_DOWN is never dropped, see krn_event_reserve_key, and repeats
+// of a key collapse into its pending KEY_DOWN. A KEY_DOWN is only dropped when
+// the keyboard lane is full of unread ones.
+#ifndef EVENT_KEYBOARD_QUEUE_SIZE
+#define EVENT_KEYBOARD_QUEUE_SIZE 64
+#endif
+
+#ifndef EVENT_POINTER_QUEUE_SIZE
+#define EVENT_POINTER_QUEUE_SIZE 32
+#endif
+
+#ifndef EVENT_TIMER_QUEUE_SIZE
+#define EVENT_TIMER_QUEUE_SIZE 4
+#endif
+
 enum {
-    EVENT_QUEUE_SIZE = 32,
-    EVENT_QUEUE_DEBUG = 0,
+    EVENT_LANE_KEYBOARD = 0,
+    EVENT_LANE_POINTER = 1,
+    EVENT_LANE_TIMER = 2,
+    EVENT_LANE_COUNT = 3,
 };
 
-static struct {
-    uint16_t head;
-    uint16_t tail;
-    event_st events[EVENT_QUEUE_SIZE];
-} krn_event_queue = { 0 };
+typedef struct {
+    const char *name;
+    event_st *events;
+    uint16_t size;
+
+    // Head is only written by the producer and tail only by the consumer
+    volatile uint16_t head;
+    volatile uint16_t tail;
+
+    uint32_t pushed;
+    uint32_t coalesced;
+    uint32_t overflows;
+} event_lane_st;
+
+static event_st krn_event_keyboard_events[EVENT_KEYBOARD_QUEUE_SIZE];
+static event_st krn_event_pointer_events[EVENT_POINTER_QUEUE_SIZE];
+static event_st krn_event_timer_events[EVENT_TIMER_QUEUE_SIZE];
+
+static event_lane_st krn_event_lanes[EVENT_LANE_COUNT] = {
+    [EVENT_LANE_KEYBOARD] = {
+        .name = "keyboard",
+        .events = krn_event_keyboard_events,
+        .size = EVENT_KEYBOARD_QUEUE_SIZE,
+    },
+    [EVENT_LANE_POINTER] = {
+        .name = "pointer",
+        .events = krn_event_pointer_events,
+        .size = EVENT_POINTER_QUEUE_SIZE,
+    },
+    [EVENT_LANE_TIMER] = {
+        .name = "timer",
+        .events = krn_event_timer_events,
+        .size = EVENT_TIMER_QUEUE_SIZE,
+    },
+};
 
-static const char *
-krn_event_format_queue(void)
-{
-    static char buf[64];
+// Sequence number of the last pushed event, used to merge the lanes in order
+static uint32_t krn_event_seq = 0;
 
-    snprintf(buf, sizeof(buf),
-        "event_queue<%02d->%02d>",
-        krn_event_queue.tail,
-        krn_event_queue.head
-    );
+// Keys whose KEY_DOWN was queued and KEY_UP wasn't yet, indexed by the key code
+// with the 0x80 bit set for extended keys, like in kernel/keyboard.c
+static uint8_t krn_event_keys_down[256 / 8];
+static uint16_t krn_event_keys_down_count = 0;
 
-    return buf;
+// Record a trace event about an event, with the first word of its payload
+static void
+krn_event_trace(uint16_t id, event_lane_st *lane, event_st *event)
+{
+    KRN_TRACE(id, (uint32_t)(lane - krn_event_lanes), event->type, event->timer_msecs);
 }
 
-static const char *
-krn_event_format(event_st ev)
+static event_lane_st *
+krn_event_lane_for(event_st *event)
 {
-    static char buf[64];
-    size_t n = sizeof(buf);
-
-    if (ev.type == EVENT_POINTER_MOVE) {
-        snprintf(buf, n, "pointer_move<%d, %d>", ev.pointer_x, ev.pointer_y);
-    } else if (ev.type == EVENT_POINTER_DOWN) {
-        snprintf(buf, n, "pointer_down<%d, %d>", ev.pointer_x, ev.pointer_y);
-    } else if (ev.type == EVENT_POINTER_UP) {
-        snprintf(buf, n, "pointer_up<%d, %d>", ev.pointer_x, ev.pointer_y);
-    } else if (ev.type == EVENT_POINTER_ALT) {
-        snprintf(buf, n, "pointer_alt<%d, %d>", ev.pointer_x, ev.pointer_y);
-    } else if (ev.type == EVENT_KEY_DOWN) {
-        snprintf(buf, n, "key_down<%d, %c>", ev.key_code, ev.key_char);
-    } else if (ev.type == EVENT_KEY_UP) {
-        snprintf(buf, n, "key_up<%d, %c>", ev.key_code, ev.key_char);
-    } else if (ev.type == EVENT_TIMER_TICK) {
-        snprintf(buf, n, "timer_tick<%u>", ev.timer_msecs);
+    if (event->type == EVENT_KEY_DOWN || event->type == EVENT_KEY_UP ||
+        event->type == EVENT_HOTKEY) {
+
+        return &krn_event_lanes[EVENT_LANE_KEYBOARD];
+    } else if (event->type == EVENT_TIMER_TICK || event->type == EVENT_TIME_CHANGE) {
+        return &krn_event_lanes[EVENT_LANE_TIMER];
     } else {
-        snprintf(buf, n, "unknown<%d>", ev.type);
+        return &krn_event_lanes[EVENT_LANE_POINTER];
     }
+}
 
-    return buf;
+static uint16_t
+krn_event_lane_count(event_lane_st *lane)
+{
+    return (lane->head + lane->size - lane->tail) % lane->size;
 }
 
-int
-krn_event_ipush(event_st event)
+// Replace the last pushed event if it's of the same type and the consumer
+// hasn't started reading it yet. Returns 0 on success.
+static int
+krn_event_coalesce(event_lane_st *lane, event_st *event)
 {
-    uint16_t next_head = (krn_event_queue.head + 1) % EVENT_QUEUE_SIZE;
+    uint16_t last = (lane->head + lane->size - 1) % lane->size;
 
-    if (event.type == EVENT_TIMER_TICK &&
-        krn_event_queue.head != krn_event_queue.tail &&
-        krn_event_queue.events[krn_event_queue.head].type == EVENT_TIMER_TICK) {
+    if (lane->head == lane->tail || last == lane->tail) {
+        return -1;
+    }
 
-        krn_event_queue.events[krn_event_queue.head].timer_msecs = event.timer_msecs;
+    event_st *prev = &lane->events[last];
 
-        if (EVENT_QUEUE_DEBUG) {
-            krn_debug_printf("%s: squashed %s\n", krn_event_format_queue(),
-                krn_event_format(event));
-        }
+    if (prev->type != event->type) {
+        return -1;
+    }
+
+    if (event->type == EVENT_TIMER_TICK) {
+        prev->timer_msecs = event->timer_msecs;
+    } else if (event->type == EVENT_POINTER_MOVE) {
+        prev->pointer_x = event->pointer_x;
+        prev->pointer_y = event->pointer_y;
+    } else if (event->type == EVENT_KEY_DOWN && (event->key_flags & KEY_FLAG_REPEAT) &&
+        prev->key_code == event->key_code &&
+        (prev->key_flags & KEY_FLAG_EXTENDED) == (event->key_flags & KEY_FLAG_EXTENDED)) {
+
+        // An auto-repeat of a key whose last KEY_DOWN wasn't read yet adds nothing
+    } else {
+        return -1;
+    }
 
+    // Keep the sequence number and the timestamp of the first event, so that it
+    // keeps its place before the events pushed later to the other lanes, and
+    // the latency is counted from the one which has been waiting the longest
+    lane->coalesced++;
+
+    return 0;
+}
+
+// Keep room in the keyboard lane for the KEY_UP of every key held down, so that
+// no key can get stuck down. Other events only take the slots left over. Returns
+// 0 if the event can be queued, and marks the key as held down or released.
+static int
+krn_event_reserve_key(event_lane_st *lane, event_st *event)
+{
+    uint8_t key = event->key_code | ((event->key_flags & KEY_FLAG_EXTENDED) ? 0x80 : 0);
+    uint8_t *byte = &krn_event_keys_down[key / 8];
+    uint8_t bit = 1 << (key % 8);
+    int is_down = (*byte & bit) != 0;
+    int room = lane->size - 1 - krn_event_lane_count(lane) - krn_event_keys_down_count;
+
+    if (event->type == EVENT_KEY_UP && is_down) {
+        *byte &= ~bit;
+        krn_event_keys_down_count--;
         return 0;
     }
 
-    if (event.type == EVENT_POINTER_MOVE &&
-        krn_event_queue.head != krn_event_queue.tail &&
-        krn_event_queue.events[krn_event_queue.head].type == EVENT_POINTER_MOVE) {
+    if (event->type != EVENT_KEY_DOWN || is_down) {
+        return room > 0 ? 0 : -1;
+    }
 
-        krn_event_queue.events[krn_event_queue.head].pointer_x = event.pointer_x;
-        krn_event_queue.events[krn_event_queue.head].pointer_y = event.pointer_y;
+    // Make room for the KEY_UP of this key as well
+    if (room < 2) {
+        return -1;
+    }
 
-        if (EVENT_QUEUE_DEBUG) {
-            krn_debug_printf("%s: squashed %s\n", krn_event_format_queue(),
-                krn_event_format(event));
-        }
+    *byte |= bit;
+    krn_event_keys_down_count++;
+    return 0;
+}
+
+// Push an event from an interrupt handler
+int
+krn_event_ipush(event_st event)
+{
+    event_lane_st *lane = krn_event_lane_for(&event);
+    uint16_t next_head = (lane->head + 1) % lane->size;
 
+    event.seq = ++krn_event_seq;
+    event.usecs = (uint32_t)krn_timer_get_usecs();
+
+    if (krn_event_coalesce(lane, &event) == 0) {
+        krn_event_trace(TRACE_EVENT_COALESCED, lane, &event);
         return 0;
     }
 
-    if (next_head == krn_event_queue.tail) {
-        if (EVENT_QUEUE_DEBUG) {
-            krn_debug_printf("%s: failed to push %s\n", krn_event_format_queue(),
-                krn_event_format(event));
-        }
+    if (next_head == lane->tail ||
+        (lane == &krn_event_lanes[EVENT_LANE_KEYBOARD] &&
+        krn_event_reserve_key(lane, &event) != 0)) {
 
+        lane->overflows++;
+        krn_event_trace(TRACE_EVENT_OVERFLOW, lane, &event);
         return -1;
     }
 
-    krn_event_queue.events[krn_event_queue.head] = event;
-    krn_event_queue.head = next_head;
+    lane->events[lane->head] = event;
+    cpu_barrier();
+    lane->head = next_head;
+    lane->pushed++;
 
-    if (EVENT_QUEUE_DEBUG && event.type != EVENT_TIMER_TICK) {
-        krn_debug_printf("%s: pushed %s\n", krn_event_format_queue(),
-            krn_event_format(event));
-    }
+    krn_event_trace(TRACE_EVENT_PUSHED, lane, &event);
+    krn_thread_wakeup(krn_event_lanes);
 
     return 0;
 }
 
+// Push an event from outside of interrupt handlers, which would otherwise
+// race with the handler owning the lane
 int
 krn_event_push(event_st event)
 {
@@ -129,48 +232,99 @@ krn_event_push(event_st event)
     return ret;
 }
 
-
-int
-krn_event_pop(event_st *event)
+// Find the lane with the oldest pending event
+static event_lane_st *
+krn_event_next_lane(void)
 {
-    uint32_t eflags;
+    event_lane_st *ret = NULL;
 
-    eflags = cpu_get_eflags();
-    cpu_cli();
+    for (int i = 0; i < EVENT_LANE_COUNT; ++i) {
+        event_lane_st *lane = &krn_event_lanes[i];
 
-    if (krn_event_queue.head == krn_event_queue.tail) {
-        if (EVENT_QUEUE_DEBUG) {
-            krn_debug_printf("%s: pop failed\n", krn_event_format_queue());
+        if (lane->head == lane->tail) {
+            continue;
         }
 
-        cpu_set_eflags(eflags);
-        return -1;
+        if (!ret || (int32_t)(lane->events[lane->tail].seq -
+            ret->events[ret->tail].seq) < 0) {
+
+            ret = lane;
+        }
     }
 
-    *event = krn_event_queue.events[krn_event_queue.tail];
+    return ret;
+}
 
-    krn_event_queue.tail = (krn_event_queue.tail + 1) % EVENT_QUEUE_SIZE;
+int
+krn_event_pop(event_st *event)
+{
+    event_lane_st *lane = krn_event_next_lane();
 
-    if (EVENT_QUEUE_DEBUG && event->type != EVENT_TIMER_TICK) {
-        krn_debug_printf("%s: popped %s\n", krn_event_format_queue(),
-            krn_event_format(*event));
+    if (!lane) {
+        return -1;
     }
 
-    cpu_set_eflags(eflags);
+    *event = lane->events[lane->tail];
+    cpu_barrier();
+    lane->tail = (lane->tail + 1) % lane->size;
+
+    krn_event_trace(TRACE_EVENT_POPPED, lane, event);
+
     return 0;
 }
 
+// Pop up to max events in the order they were pushed. Sets more if there are
+// events left in the queues afterwards. Returns the number of popped events.
+size_t
+krn_event_pop_many(event_st *events, size_t max, int *more)
+{
+    size_t count = 0;
+
+    while (count < max && krn_event_pop(&events[count]) == 0) {
+        count++;
+    }
+
+    *more = (krn_event_next_lane() != NULL);
+
+    return count;
+}
+
 uint16_t
 krn_event_count(void)
 {
-    uint32_t eflags;
+    uint16_t ret = 0;
 
-    eflags = cpu_get_eflags();
+    for (int i = 0; i < EVENT_LANE_COUNT; ++i) {
+        ret += krn_event_lane_count(&krn_event_lanes[i]);
+    }
+
+    return ret;
+}
+
+// Block the current thread until there are pending events. Other threads run in
+// the meantime, and the CPU halts in the idle thread once none of them is ready.
+void
+krn_event_wait(void)
+{
+    uint32_t eflags = cpu_get_eflags();
     cpu_cli();
 
-    uint16_t ret = (krn_event_queue.head - krn_event_queue.tail) % EVENT_QUEUE_SIZE;
+    // An event pushed right after the check still wakes up the thread,
+    // since interrupts stay disabled until it's blocked
+    while (krn_event_count() == 0) {
+        krn_thread_wait(krn_event_lanes);
+    }
 
     cpu_set_eflags(eflags);
-    return ret;
 }
 
+void
+krn_event_dump_stats(void)
+{
+    for (int i = 0; i < EVENT_LANE_COUNT; ++i) {
+        event_lane_st *lane = &krn_event_lanes[i];
+
+        krn_debug_printf("events: %-8s pushed: %u, coalesced: %u, overflows: %u\n",
+            lane->name, lane->pushed, lane->coalesced, lane->overflows);
+    }
+}
@@ -0,0 +1,246 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: heap.c - Slab allocators for size classes and arenas for temporary data
+// --------------------------------------------------------------------------------------
+
+#include <kernel.h>
+
+enum {
+    HEAP_CLASS_COUNT = 8,
+    HEAP_CLASS_LARGE = 0xFFFF,
+    HEAP_MIN_SIZE = 16,
+};
+
+// Header at the start of every page (or run of pages) owned by the heap
+typedef struct heap_slab {
+    struct heap_slab *next;
+    void *free_list;
+    uint16_t class_idx;
+    uint16_t used;
+    uint32_t pages;
+} heap_slab_st;
+
+typedef struct {
+    heap_slab_st *slabs;
+    uint32_t slab_count;
+    uint32_t used;
+    uint32_t allocs;
+    uint32_t frees;
+} heap_class_st;
+
+static heap_class_st heap_classes[HEAP_CLASS_COUNT];
+
+static struct {
+    uint32_t large_count;
+    uint32_t large_pages;
+    uint32_t failures;
+} heap_stats;
+
+static size_t
+krn_heap_class_size(int class_idx)
+{
+    return HEAP_MIN_SIZE << class_idx;
+}
+
+static int
+krn_heap_class_for(size_t size)
+{
+    for (int i = 0; i < HEAP_CLASS_COUNT; ++i) {
+        if (size <= krn_heap_class_size(i)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static heap_slab_st *
+krn_heap_new_slab(int class_idx)
+{
+    heap_slab_st *slab = krn_page_alloc(1);
+    size_t size = krn_heap_class_size(class_idx);
+
+    if (!slab) {
+        return NULL;
+    }
+
+    slab->class_idx = class_idx;
+    slab->used = 0;
+    slab->pages = 1;
+    slab->free_list = NULL;
+
+    // Thread all objects of the page into the free list, lowest address first
+    uint8_t *first = (uint8_t *)slab + MAX(sizeof(heap_slab_st), size);
+    uint8_t *last = (uint8_t *)slab + PAGE_SIZE - size;
+
+    for (uint8_t *obj = last; obj >= first; obj -= size) {
+        *(void **)obj = slab->free_list;
+        slab->free_list = obj;
+    }
+
+    slab->next = heap_classes[class_idx].slabs;
+    heap_classes[class_idx].slabs = slab;
+    heap_classes[class_idx].slab_count++;
+
+    return slab;
+}
+
+static void
+krn_heap_release_slab(heap_class_st *cls, heap_slab_st *slab)
+{
+    for (heap_slab_st **p = &cls->slabs; *p; p = &(*p)->next) {
+        if (*p == slab) {
+            *p = slab->next;
+            cls->slab_count--;
+            krn_page_free(slab, 1);
+            return;
+        }
+    }
+}
+
+void *
+krn_heap_alloc(size_t size)
+{
+    int class_idx = krn_heap_class_for(size);
+    void *ret = NULL;
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    if (class_idx < 0) {
+        uint32_t pages = (size + sizeof(heap_slab_st) + PAGE_SIZE - 1) / PAGE_SIZE;
+        heap_slab_st *slab = krn_page_alloc(pages);
+
+        if (slab) {
+            slab->class_idx = HEAP_CLASS_LARGE;
+            slab->pages = pages;
+            heap_stats.large_count++;
+            heap_stats.large_pages += pages;
+            ret = slab + 1;
+        }
+    } else {
+        heap_class_st *cls = &heap_classes[class_idx];
+        heap_slab_st *slab = cls->slabs;
+
+        while (slab && !slab->free_list) {
+            slab = slab->next;
+        }
+
+        if (!slab) {
+            slab = krn_heap_new_slab(class_idx);
+        }
+
+        if (slab) {
+            ret = slab->free_list;
+            slab->free_list = *(void **)ret;
+            slab->used++;
+            cls->used++;
+            cls->allocs++;
+        }
+    }
+
+    if (!ret) {
+        heap_stats.failures++;
+    }
+
+    cpu_set_eflags(eflags);
+
+    if (!ret) {
+        krn_debug_printf("heap: failed to allocate %u bytes\n", size);
+        krn_heap_dump_stats();
+    }
+
+    return ret;
+}
+
+void
+krn_heap_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    heap_slab_st *slab = (heap_slab_st *)((uint32_t)ptr & ~(PAGE_SIZE - 1));
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    if (slab->class_idx == HEAP_CLASS_LARGE) {
+        heap_stats.large_count--;
+        heap_stats.large_pages -= slab->pages;
+        krn_page_free(slab, slab->pages);
+    } else {
+        heap_class_st *cls = &heap_classes[slab->class_idx];
+
+        *(void **)ptr = slab->free_list;
+        slab->free_list = ptr;
+        slab->used--;
+        cls->used--;
+        cls->frees++;
+
+        // Keep one empty slab around to avoid thrashing
+        if (slab->used == 0 && cls->slab_count > 1) {
+            krn_heap_release_slab(cls, slab);
+        }
+    }
+
+    cpu_set_eflags(eflags);
+}
+
+void
+krn_heap_dump_stats(void)
+{
+    krn_debug_printf("heap: large: %u allocations in %u pages, failures: %u\n",
+        heap_stats.large_count, heap_stats.large_pages, heap_stats.failures);
+
+    for (int i = 0; i < HEAP_CLASS_COUNT; ++i) {
+        heap_class_st *cls = &heap_classes[i];
+        size_t size = krn_heap_class_size(i);
+        uint32_t per_slab = (PAGE_SIZE - MAX(sizeof(heap_slab_st), size)) / size;
+        uint32_t capacity = cls->slab_count * per_slab;
+
+        krn_debug_printf("  %4u B: %u slabs, %u/%u used, allocs: %u, frees: %u\n",
+            size, cls->slab_count, cls->used, capacity, cls->allocs, cls->frees);
+    }
+
+    krn_page_dump_stats();
+}
+
+// Set up an arena backed by a run of pages
+int
+krn_arena_init(krn_arena_st *arena, uint32_t pages)
+{
+    arena->base = krn_page_alloc(pages);
+    arena->size = arena->base ? pages * PAGE_SIZE : 0;
+    arena->used = 0;
+    arena->peak = 0;
+    arena->failures = 0;
+
+    return arena->base ? 0 : -1;
+}
+
+// Allocate temporary memory, which stays valid until the next reset
+void *
+krn_arena_alloc(krn_arena_st *arena, size_t size)
+{
+    size = (size + 15) & ~15;
+
+    if (arena->used + size > arena->size) {
+        arena->failures++;
+        return NULL;
+    }
+
+    void *ret = arena->base + arena->used;
+    arena->used += size;
+    arena->peak = MAX(arena->peak, arena->used);
+
+    return ret;
+}
+
+void
+krn_arena_reset(krn_arena_st *arena)
+{
+    arena->used = 0;
+}
@@ -9,12 +9,29 @@
 
 static isr_handler_fn krn_interrupt_handlers[64] = { NULL };
 
-void
+// Set while running a handler. Handlers don't enable interrupts, so they don't nest.
+static volatile uint8_t krn_interrupt_active = 0;
+
+// Returns the registers to restore, of another thread if the handler made
+// one ready, see kernel/thread.c
+isr_stack_st *
 krn_interrupt_handle(isr_stack_st *isr_stack)
 {
+    krn_interrupt_active = 1;
+
     if (krn_interrupt_handlers[isr_stack->int_no]) {
         krn_interrupt_handlers[isr_stack->int_no](isr_stack);
     }
+
+    krn_interrupt_active = 0;
+
+    return krn_thread_schedule(isr_stack);
+}
+
+int
+krn_interrupt_is_active(void)
+{
+    return krn_interrupt_active;
 }
 
 void
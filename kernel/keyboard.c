@@ -34,57 +34,207 @@ static const unsigned char krn_keyboard_map_shift[] = {
     '-', 252, 0, 253, '+', 0, 255, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 };
 
+// Pressed keys, one bit per key code, with extended keys in the upper half.
+// Only written by the interrupt handler, so it can be read without locking.
+static volatile uint32_t keyboard_state[8];
+
+// Software auto-repeat, used instead of the typematic repeat when the delay is set
+static struct {
+    uint16_t delay;
+    uint16_t rate;
+    uint8_t active;
+    uint32_t next;
+    event_st event;
+} keyboard_repeat;
+
+static int
+krn_keyboard_test_key(uint8_t key)
+{
+    return (keyboard_state[key >> 5] >> (key & 31)) & 1;
+}
+
+static void
+krn_keyboard_update_key(uint8_t key, int pressed)
+{
+    if (pressed) {
+        keyboard_state[key >> 5] |= 1U << (key & 31);
+    } else {
+        keyboard_state[key >> 5] &= ~(1U << (key & 31));
+    }
+}
+
+// Start or stop repeating a key. Must be called with interrupts disabled.
+static void
+krn_keyboard_track_repeat(event_st ev, int was_pressed)
+{
+    if (ev.type == EVENT_KEY_DOWN && !was_pressed) {
+        keyboard_repeat.event = ev;
+        keyboard_repeat.event.key_flags |= KEY_FLAG_REPEAT;
+        keyboard_repeat.next = krn_timer_get_msecs() + keyboard_repeat.delay;
+        keyboard_repeat.active = 1;
+        krn_timer_reschedule();
+    } else if (ev.type == EVENT_KEY_UP && keyboard_repeat.active &&
+        keyboard_repeat.event.key_code == ev.key_code &&
+        keyboard_repeat.event.key_flags == (ev.key_flags | KEY_FLAG_REPEAT)) {
+
+        keyboard_repeat.active = 0;
+    }
+}
+
 static void
 krn_keyboard_handle_intr(isr_stack_st *isr_stack __attribute__((unused)))
 {
     static uint8_t shift = 0;
     static uint8_t ctrl = 0;
     static uint8_t alt = 0;
+    static uint8_t extended = 0;
+    static uint8_t skip = 0;
 
     uint8_t scan;
     int evtype;
 
     scan = inb(PS2_PORT_DATA);
 
+    // The rest of the Pause key sequence, which has no release code
+    if (skip > 0) {
+        skip--;
+        return;
+    }
+
+    if (scan == 0xe1) {
+        skip = 5;
+        return;
+    }
+
     if (scan == 0xe0) {
+        extended = 1;
         return;
     }
 
+    uint8_t flags = extended ? KEY_FLAG_EXTENDED : 0;
+    extended = 0;
+
     evtype = scan & 0x80 ? EVENT_KEY_UP : EVENT_KEY_DOWN,
     scan = scan & 0x7f;
 
+    // Skip the fake shifts sent around extended keys when Shift or NumLock is on
+    if ((flags & KEY_FLAG_EXTENDED) && (scan == 0x2a || scan == 0x36)) {
+        return;
+    }
+
+    uint8_t key = (flags & KEY_FLAG_EXTENDED) ? (scan | 0x80) : scan;
+    int was_pressed = krn_keyboard_test_key(key);
+
+    krn_keyboard_update_key(key, evtype == EVENT_KEY_DOWN);
+
     if (scan >= sizeof(krn_keyboard_map_default)) {
         return;
     }
 
+    // Typematic repeats are key downs without key ups in between
+    if (evtype == EVENT_KEY_DOWN && was_pressed) {
+        if (keyboard_repeat.delay) {
+            return;
+        }
+
+        flags |= KEY_FLAG_REPEAT;
+    }
+
     event_st ev = {
         .type = evtype,
         .key_code = scan,
         .key_char = shift ? krn_keyboard_map_shift[scan] : krn_keyboard_map_default[scan],
+        .key_flags = flags,
     };
 
     if (KBD_DEBUG) {
-        krn_debug_printf("keyboard event: %s code=%02X char=%02X (%c)\n",
+        krn_debug_printf("keyboard event: %s code=%02X char=%02X (%c) flags=%02X\n",
             ev.type == EVENT_KEY_UP ? "up" : "down",
             ev.key_code,
             ev.key_char,
-            ev.key_char ? ev.key_char : ' '
+            ev.key_char ? ev.key_char : ' ',
+            ev.key_flags
         );
     }
 
+    int hotkey = ctrl && alt && ev.type == EVENT_KEY_DOWN;
+
     if (ev.key_code == 0x2a || ev.key_code == 0x36) {
         shift = (ev.type == EVENT_KEY_UP) ? 0 : 1;
     } else if (ev.key_code == 0x1d) {
         ctrl = (ev.type == EVENT_KEY_UP) ? 0 : 1;
     } else if (ev.key_code == 0x38) {
         alt = (ev.type == EVENT_KEY_UP) ? 0 : 1;
-    } else if (ev.key_code == 0x53 && ctrl && alt && ev.type == EVENT_KEY_DOWN) {
+    } else if (hotkey && ev.key_code == HOTKEY_REBOOT) {
         outb(0xFE, PS2_PORT_CMD);
+    } else if (hotkey && ev.key_code == HOTKEY_PROFILE) {
+        krn_profile_toggle();
+    } else if (hotkey && ev.key_code == HOTKEY_TRACE) {
+        krn_trace_toggle();
+    } else if (hotkey && ev.key_code == HOTKEY_OVERLAY) {
+        // The debug overlay is drawn by the GUI, so let it know
+        ev.type = EVENT_HOTKEY;
+        (void)krn_event_ipush(ev);
     } else {
+        if (keyboard_repeat.delay) {
+            krn_keyboard_track_repeat(ev, was_pressed);
+        }
+
         (void)krn_event_ipush(ev);
     }
 }
 
+// Called from the timer interrupt handler
+void
+krn_keyboard_on_tick(uint32_t msecs)
+{
+    if (!keyboard_repeat.active || (int32_t)(msecs - keyboard_repeat.next) < 0) {
+        return;
+    }
+
+    (void)krn_event_ipush(keyboard_repeat.event);
+
+    // Don't try to catch up with the repeats missed while the tick was late
+    while ((int32_t)(msecs - keyboard_repeat.next) >= 0) {
+        keyboard_repeat.next += keyboard_repeat.rate;
+    }
+}
+
+// Get the time of the next repeat. Returns 0 if no key is repeating.
+int
+krn_keyboard_get_deadline(uint32_t *msecs)
+{
+    *msecs = keyboard_repeat.next;
+    return keyboard_repeat.active;
+}
+
+// Check if a key is held down. Codes with the 0x80 bit set only match extended keys,
+// other codes match both variants, e.g. 0x48 matches both the arrow and keypad 8.
+int
+krn_keyboard_is_pressed(uint8_t code)
+{
+    if (code & 0x80) {
+        return krn_keyboard_test_key(code);
+    }
+
+    return krn_keyboard_test_key(code) || krn_keyboard_test_key(code | 0x80);
+}
+
+// Repeat held keys in software every rate msecs, starting delay msecs after the press.
+// Set the delay to 0 to go back to the typematic repeat of the keyboard.
+void
+krn_keyboard_set_repeat(uint16_t delay, uint16_t rate)
+{
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    keyboard_repeat.delay = delay;
+    keyboard_repeat.rate = MAX(rate, 1);
+    keyboard_repeat.active = 0;
+
+    cpu_set_eflags(eflags);
+}
+
 void
 krn_keyboard_init(void)
 {
@@ -11,13 +11,21 @@
 void
 krn_main(void)
 {
+    krn_serial_init();
     krn_timer_init();
+    krn_rtc_init();
     krn_keyboard_init();
     krn_mouse_init();
 
     krn_debug_dump_multiboot_info();
     krn_debug_dump_kernel_location();
 
+    krn_page_init();
+    krn_heap_dump_stats();
+
+    krn_thread_init("gui", THREAD_PRIORITY_HIGH);
+    krn_debug_init();
+
     rand_init();
     gui_main();
 
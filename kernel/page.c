@@ -0,0 +1,315 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: page.c - Physical page frame allocator
+// --------------------------------------------------------------------------------------
+
+#include <kernel.h>
+
+// One bit per page frame, set means the page is used or not available
+static uint8_t *page_bitmap = NULL;
+static uint32_t page_count = 0;
+static uint32_t page_free_count = 0;
+static uint32_t page_hint = 0;
+
+static struct {
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failures;
+} page_stats;
+
+static int
+krn_page_is_used(uint32_t page)
+{
+    return page_bitmap[page >> 3] & (1 << (page & 7));
+}
+
+static void
+krn_page_mark(uint32_t first, uint32_t count, int used)
+{
+    for (uint32_t page = first; page < first + count && page < page_count; ++page) {
+        if (!!krn_page_is_used(page) == !!used) {
+            continue;
+        }
+
+        if (used) {
+            page_bitmap[page >> 3] |= (1 << (page & 7));
+            page_free_count--;
+        } else {
+            page_bitmap[page >> 3] &= ~(1 << (page & 7));
+            page_free_count++;
+        }
+    }
+}
+
+static void
+krn_page_mark_range(uint32_t addr, uint32_t len, int used)
+{
+    uint32_t first = addr / PAGE_SIZE;
+    uint32_t last = (addr + len + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    krn_page_mark(first, last - first, used);
+}
+
+// Call fn for every structure passed by the bootloader that we still need
+static void
+krn_page_for_each_boot_data(void (*fn)(uint32_t addr, uint32_t len, void *payload),
+    void *payload)
+{
+    mboot_info_st *m = krn_core_mboot_info;
+
+    fn((uint32_t)m, sizeof(*m), payload);
+    fn((uint32_t)m->mmap_addr, m->mmap_length, payload);
+
+    if (m->flags & 0x04) {
+        fn((uint32_t)m->cmdline, strlen(m->cmdline) + 1, payload);
+        fn((uint32_t)m->boot_loader_name, strlen(m->boot_loader_name) + 1, payload);
+    }
+}
+
+static void
+krn_page_skip_boot_data(uint32_t addr, uint32_t len, void *payload)
+{
+    uint32_t *range = payload;
+
+    if (addr + len > range[0] && addr < range[0] + range[1]) {
+        range[0] = (addr + len + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    }
+}
+
+static void
+krn_page_reserve_boot_data(uint32_t addr, uint32_t len, void *payload _unsd)
+{
+    krn_page_mark_range(addr, len, 1);
+}
+
+// Get the page-aligned part of a memory map entry that lies above the kernel image.
+// Returns 0 if there is no such part.
+static int
+krn_page_usable_range(mboot_mmap_entry_st *e, uint32_t *start, uint32_t *end)
+{
+    uint64_t kernel_end = ((uint32_t)&krn_link_end + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    uint64_t addr = e->addr;
+    uint64_t top = e->addr + e->len;
+
+    if (e->type != 1) {
+        return 0;
+    }
+
+    addr = MAX(addr, kernel_end);
+    addr = (addr + PAGE_SIZE - 1) & ~(uint64_t)(PAGE_SIZE - 1);
+    top = MIN(top, 0x100000000ULL - PAGE_SIZE) & ~(uint64_t)(PAGE_SIZE - 1);
+
+    if (addr >= top) {
+        return 0;
+    }
+
+    *start = (uint32_t)addr;
+    *end = (uint32_t)top;
+
+    return 1;
+}
+
+static uint8_t *
+krn_page_place_bitmap(mboot_mmap_entry_st *mmap_start, mboot_mmap_entry_st *mmap_end,
+    uint32_t size)
+{
+    uint32_t start, end;
+
+    for (mboot_mmap_entry_st *e = mmap_start; e < mmap_end; ++e) {
+        if (!krn_page_usable_range(e, &start, &end)) {
+            continue;
+        }
+
+        uint32_t range[2] = { start, size };
+
+        // Repeat until the range doesn't overlap any of the boot structures
+        do {
+            start = range[0];
+            krn_page_for_each_boot_data(krn_page_skip_boot_data, range);
+        } while (range[0] != start);
+
+        if (start + size <= end) {
+            return (uint8_t *)start;
+        }
+    }
+
+    return NULL;
+}
+
+// Allocate count physically contiguous pages. Returns NULL on failure.
+void *
+krn_page_alloc(uint32_t count)
+{
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    uint32_t run = 0;
+
+    for (uint32_t i = 0; i < page_count && count > 0; ++i) {
+        uint32_t page = (page_hint + i) % page_count;
+
+        // Runs can't wrap around the end of memory
+        if (page == 0) {
+            run = 0;
+        }
+
+        if (krn_page_is_used(page)) {
+            run = 0;
+            continue;
+        }
+
+        if (++run < count) {
+            continue;
+        }
+
+        uint32_t first = page + 1 - count;
+        krn_page_mark(first, count, 1);
+        page_hint = (page + 1) % page_count;
+        page_stats.allocs++;
+
+        cpu_set_eflags(eflags);
+        return (void *)(first * PAGE_SIZE);
+    }
+
+    page_stats.failures++;
+
+    cpu_set_eflags(eflags);
+    return NULL;
+}
+
+void
+krn_page_free(void *addr, uint32_t count)
+{
+    uint32_t first = (uint32_t)addr / PAGE_SIZE;
+
+    if (!addr) {
+        return;
+    }
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    krn_page_mark(first, count, 0);
+    page_stats.frees++;
+
+    if (first < page_hint) {
+        page_hint = first;
+    }
+
+    cpu_set_eflags(eflags);
+}
+
+uint32_t
+krn_page_get_free_count(void)
+{
+    return page_free_count;
+}
+
+uint32_t
+krn_page_get_total_count(void)
+{
+    return page_count;
+}
+
+static int
+krn_page_run_bucket(uint32_t run)
+{
+    static const uint32_t limits[5] = { 2, 4, 16, 64, 256 };
+    int bucket = 0;
+
+    while (bucket < 5 && run >= limits[bucket]) {
+        bucket++;
+    }
+
+    return bucket;
+}
+
+void
+krn_page_dump_stats(void)
+{
+    uint32_t runs = 0, largest = 0, run = 0;
+    uint32_t histogram[6] = { 0 };
+    static const char *histogram_labels[6] = {
+        "1", "2-3", "4-15", "16-63", "64-255", "256+",
+    };
+
+    for (uint32_t page = 0; page <= page_count; ++page) {
+        if (page < page_count && !krn_page_is_used(page)) {
+            run++;
+            continue;
+        }
+
+        if (run == 0) {
+            continue;
+        }
+
+        runs++;
+        largest = MAX(largest, run);
+        histogram[krn_page_run_bucket(run)]++;
+        run = 0;
+    }
+
+    krn_debug_printf("pages: %u free of %u, allocs: %u, frees: %u, failures: %u\n",
+        page_free_count, page_count, page_stats.allocs, page_stats.frees,
+        page_stats.failures);
+
+    // Fragmentation is the share of free memory outside of the largest free run
+    krn_debug_printf("pages: %u free runs, largest: %u pages, fragmentation: %u%%\n",
+        runs, largest, page_free_count ? 100 - largest * 100 / page_free_count : 0);
+
+    for (int i = 0; i < 6; ++i) {
+        krn_debug_printf("  runs of %s pages: %u\n", histogram_labels[i], histogram[i]);
+    }
+}
+
+// Initialize the allocator with all memory above the kernel image
+// which the BIOS memory map reports as available
+void
+krn_page_init(void)
+{
+    mboot_info_st *m = krn_core_mboot_info;
+    uint32_t start, end, top = 0;
+
+    if (!(m->flags & 0x40)) {
+        krn_debug_printf("pages: no memory map\n");
+        return;
+    }
+
+    mboot_mmap_entry_st *mmap_start = m->mmap_addr;
+    mboot_mmap_entry_st *mmap_end = (mboot_mmap_entry_st *)
+        ((uint32_t)mmap_start + m->mmap_length);
+
+    for (mboot_mmap_entry_st *e = mmap_start; e < mmap_end; ++e) {
+        if (krn_page_usable_range(e, &start, &end)) {
+            top = MAX(top, end);
+        }
+    }
+
+    uint32_t count = top / PAGE_SIZE;
+    uint32_t bitmap_size = (count + 7) / 8;
+
+    page_bitmap = krn_page_place_bitmap(mmap_start, mmap_end, bitmap_size);
+
+    if (!page_bitmap) {
+        krn_debug_printf("pages: no space for the bitmap\n");
+        return;
+    }
+
+    memset(page_bitmap, 0xFF, bitmap_size);
+    page_count = count;
+    page_free_count = 0;
+
+    for (mboot_mmap_entry_st *e = mmap_start; e < mmap_end; ++e) {
+        if (krn_page_usable_range(e, &start, &end)) {
+            krn_page_mark_range(start, end - start, 0);
+        }
+    }
+
+    krn_page_mark_range((uint32_t)page_bitmap, bitmap_size, 1);
+    krn_page_for_each_boot_data(krn_page_reserve_boot_data, NULL);
+
+    krn_debug_printf("pages: bitmap at %08x, %u of %u pages free\n",
+        (uint32_t)page_bitmap, page_free_count, page_count);
+}
@@ -0,0 +1,153 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: profile.c - Sampling profiler driven by the timer interrupt
+// --------------------------------------------------------------------------------------
+
+#include <kernel.h>
+
+// While profiling, the timer interrupts PROFILE_HZ times per second and every
+// interrupt records the interrupted EIP, followed by up to PROFILE_CALLERS
+// return addresses found by following the saved frame pointers. Samples are
+// kept in a ring, so the newest ones win, and they are dumped to the debug port
+// after profiling stops, once the CPU goes idle. See misc/profile.py.
+
+#ifndef PROFILE_HZ
+#define PROFILE_HZ 1000
+#endif
+
+// Following frame pointers requires building with -fno-omit-frame-pointer
+#ifndef PROFILE_CALLERS
+#define PROFILE_CALLERS 0
+#endif
+
+enum {
+    PROFILE_SAMPLES_MAX = 8192,
+    PROFILE_SAMPLE_WORDS = 1 + PROFILE_CALLERS,
+};
+
+static uint32_t profile_samples[PROFILE_SAMPLES_MAX * PROFILE_SAMPLE_WORDS];
+static uint32_t profile_head = 0;
+static uint32_t profile_count = 0;
+static uint32_t profile_dropped = 0;
+static uint32_t profile_started_at = 0;
+static uint32_t profile_msecs = 0;
+
+static volatile uint8_t profile_active = 0;
+static volatile uint8_t profile_pending = 0;
+
+// Follow the chain of saved frame pointers on the stack of the interrupted thread.
+// A frame pointer which doesn't point further up the stack ends the chain.
+static void
+krn_profile_walk(uint32_t ebp, uint32_t *callers)
+{
+    uint32_t stack_start, stack_end;
+
+    krn_thread_get_stack(&stack_start, &stack_end);
+
+    for (int i = 0; i < PROFILE_CALLERS; ++i) {
+        if (ebp < stack_start || ebp + 8 > stack_end || (ebp & 3)) {
+            callers[i] = 0;
+            continue;
+        }
+
+        uint32_t *frame = (uint32_t *)ebp;
+
+        callers[i] = frame[1];
+        ebp = frame[0] > ebp ? frame[0] : 0;
+    }
+}
+
+// Called from the timer interrupt handler
+void
+krn_profile_on_tick(isr_stack_st *isr_stack)
+{
+    if (!profile_active) {
+        return;
+    }
+
+    uint32_t *sample = &profile_samples[profile_head * PROFILE_SAMPLE_WORDS];
+
+    sample[0] = isr_stack->eip;
+    krn_profile_walk(isr_stack->ebp, sample + 1);
+
+    profile_head = (profile_head + 1) % PROFILE_SAMPLES_MAX;
+
+    if (profile_count < PROFILE_SAMPLES_MAX) {
+        profile_count++;
+    } else {
+        profile_dropped++;
+    }
+}
+
+void
+krn_profile_start(void)
+{
+    profile_head = 0;
+    profile_count = 0;
+    profile_dropped = 0;
+    profile_started_at = krn_timer_get_msecs();
+    profile_pending = 0;
+    profile_active = 1;
+
+    krn_timer_set_sample_rate(PROFILE_HZ);
+    krn_debug_beep(1000, 50, 1);
+}
+
+void
+krn_profile_stop(void)
+{
+    profile_active = 0;
+    profile_msecs = krn_timer_get_msecs() - profile_started_at;
+    profile_pending = 1;
+
+    krn_timer_set_sample_rate(0);
+    krn_debug_beep(1000, 50, 2);
+    krn_debug_dump_wakeup();
+}
+
+// Called from the keyboard interrupt handler on Ctrl+Alt+P
+void
+krn_profile_toggle(void)
+{
+    if (profile_active) {
+        krn_profile_stop();
+    } else {
+        krn_profile_start();
+    }
+}
+
+// Dump the samples of the last run, if it wasn't dumped yet. Every sample
+// is an EIP followed by the return addresses, oldest sample first.
+void
+krn_profile_dump(void)
+{
+    static char line[12 * PROFILE_SAMPLE_WORDS + 16];
+
+    if (!profile_pending || profile_active) {
+        return;
+    }
+
+    profile_pending = 0;
+
+    krn_debug_printf("profile: begin hz=%u msecs=%u samples=%u dropped=%u callers=%u\n",
+        PROFILE_HZ, profile_msecs, profile_count, profile_dropped, PROFILE_CALLERS);
+
+    uint32_t first = (profile_head + PROFILE_SAMPLES_MAX - profile_count)
+        % PROFILE_SAMPLES_MAX;
+
+    for (uint32_t i = 0; i < profile_count; ++i) {
+        uint32_t *sample = &profile_samples[((first + i) % PROFILE_SAMPLES_MAX)
+            * PROFILE_SAMPLE_WORDS];
+        size_t len = snprintf(line, sizeof(line), "profile: s %08x", sample[0]);
+
+        for (int j = 1; j < PROFILE_SAMPLE_WORDS && sample[j]; ++j) {
+            len += snprintf(line + len, sizeof(line) - len, " %08x", sample[j]);
+        }
+
+        krn_debug_printf("%s\n", line);
+    }
+
+    krn_debug_printf("profile: end\n");
+}
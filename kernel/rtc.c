@@ -10,8 +10,15 @@
 enum {
     RTC_PORT_ADDR = 0x70,
     RTC_PORT_DATA = 0x71,
+    RTC_CACHE_MAX_AGE = 2000,
 };
 
+// Time read by the interrupt handler on every update, guarded by a sequence
+// number so that readers can copy it without disabling interrupts
+static time_st rtc_cache;
+static uint32_t rtc_cache_msecs = 0;
+static volatile uint32_t rtc_cache_seq = 0;
+
 static uint16_t
 krn_rtc_parse_bcd(uint16_t bcd)
 {
@@ -40,7 +47,6 @@ krn_rtc_is_update_in_progress(void)
 static void
 krn_rtc_read_raw_time(time_st *t)
 {
-
     t->second = krn_rtc_get_reg(0x00);
     t->minute = krn_rtc_get_reg(0x02);
     t->hour = krn_rtc_get_reg(0x04);
@@ -60,50 +66,146 @@ krn_rtc_are_times_equal(time_st *t1, time_st *t2)
         t1->second == t2->second;
 }
 
-void
-krn_rtc_get_time(time_st *t)
+// Convert raw register values to binary 24h format
+static void
+krn_rtc_convert_time(time_st *t)
 {
-    time_st t1, t2;
     uint8_t reg_b;
     int is_bcd, is_12h, is_pm;
 
-    // Keep reading raw time until we obtain two identical values twice
-    // in a row. This prevents getting an inconsistent state in case
-    // we try to read it during RTC update
-    do {
-        while (krn_rtc_is_update_in_progress()) { };
-        krn_rtc_read_raw_time(&t1);
-
-        while (krn_rtc_is_update_in_progress()) { };
-        krn_rtc_read_raw_time(&t2);
-    } while (!krn_rtc_are_times_equal(&t1, &t2));
-
     // Check status flags
     reg_b = krn_rtc_get_reg(0x0b);
     is_bcd = !(reg_b & 0x04);
     is_12h = !(reg_b & 0x02);
-    is_pm = !!(t2.hour & 0x80);
+    is_pm = !!(t->hour & 0x80);
 
     // Clear the PM bit
-    t2.hour = t2.hour & 0x7F;
+    t->hour = t->hour & 0x7F;
 
     // Parse BCD values
     if (is_bcd) {
-        t2.second = krn_rtc_parse_bcd(t2.second);
-        t2.minute = krn_rtc_parse_bcd(t2.minute);
-        t2.hour = krn_rtc_parse_bcd(t2.hour);
-        t2.day = krn_rtc_parse_bcd(t2.day);
-        t2.month = krn_rtc_parse_bcd(t2.month);
-        t2.year = krn_rtc_parse_bcd(t2.year);
+        t->second = krn_rtc_parse_bcd(t->second);
+        t->minute = krn_rtc_parse_bcd(t->minute);
+        t->hour = krn_rtc_parse_bcd(t->hour);
+        t->day = krn_rtc_parse_bcd(t->day);
+        t->month = krn_rtc_parse_bcd(t->month);
+        t->year = krn_rtc_parse_bcd(t->year);
     }
 
     // Convert 12h format to 24h
     if (is_12h && is_pm) {
-        t2.hour = (t2.hour + 12) % 24;
+        t->hour = (t->hour + 12) % 24;
     }
 
     // Calculate full year
-    t2.year += (t2.year < 70) ? 2000 : 1900;
+    t->year += (t->year < 70) ? 2000 : 1900;
+}
+
+// Read the time at any moment, waiting for an update to finish if necessary
+static void
+krn_rtc_read_time(time_st *t)
+{
+    time_st t1, t2;
+
+    // Keep reading raw time until we obtain two identical values twice
+    // in a row. This prevents getting an inconsistent state in case
+    // we try to read it during RTC update
+    do {
+        while (krn_rtc_is_update_in_progress()) { };
+        krn_rtc_read_raw_time(&t1);
+
+        while (krn_rtc_is_update_in_progress()) { };
+        krn_rtc_read_raw_time(&t2);
+    } while (!krn_rtc_are_times_equal(&t1, &t2));
+
+    krn_rtc_convert_time(&t2);
 
     memcpy(t, &t2, sizeof(t2));
 }
+
+static void
+krn_rtc_set_cached_time(time_st *t)
+{
+    // Odd sequence numbers mark the cache as being written
+    rtc_cache_seq++;
+    cpu_barrier();
+    rtc_cache = *t;
+    rtc_cache_msecs = krn_timer_get_msecs();
+    cpu_barrier();
+    rtc_cache_seq++;
+}
+
+static void
+krn_rtc_handle_intr(isr_stack_st *isr_stack _unsd)
+{
+    // Reading register C acknowledges the interrupt,
+    // no other RTC interrupt is raised until that happens
+    uint8_t reg_c = krn_rtc_get_reg(0x0c);
+
+    if (!(reg_c & 0x10)) {
+        return;
+    }
+
+    // Right after the update ended, the registers are stable for almost a second
+    time_st t;
+    krn_rtc_read_raw_time(&t);
+    krn_rtc_convert_time(&t);
+    krn_rtc_set_cached_time(&t);
+
+    event_st event = {
+        .type = EVENT_TIME_CHANGE,
+    };
+
+    (void)krn_event_ipush(event);
+}
+
+// Get the time cached by the interrupt handler, without any port I/O
+void
+krn_rtc_get_time(time_st *t)
+{
+    uint32_t seq, msecs;
+
+    do {
+        seq = rtc_cache_seq;
+        cpu_barrier();
+        *t = rtc_cache;
+        msecs = rtc_cache_msecs;
+        cpu_barrier();
+    } while ((seq & 1) || seq != rtc_cache_seq);
+
+    // Fall back to reading the registers if the interrupts stopped coming
+    if (krn_timer_get_msecs() - msecs > RTC_CACHE_MAX_AGE) {
+        uint32_t eflags = cpu_get_eflags();
+        cpu_cli();
+
+        krn_rtc_read_time(t);
+        krn_rtc_set_cached_time(t);
+
+        cpu_set_eflags(eflags);
+    }
+}
+
+void
+krn_rtc_init(void)
+{
+    time_st t;
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    krn_rtc_read_time(&t);
+    krn_rtc_set_cached_time(&t);
+
+    // Enable the update-ended interrupt in register B, with NMI disabled
+    outb(0x8b, RTC_PORT_ADDR);
+    uint8_t reg_b = inb(RTC_PORT_DATA);
+    outb(0x8b, RTC_PORT_ADDR);
+    outb(reg_b | 0x10, RTC_PORT_DATA);
+
+    // Clear any pending interrupt flags
+    (void)krn_rtc_get_reg(0x0c);
+
+    cpu_set_eflags(eflags);
+
+    krn_interrupt_set_handler(0x28, krn_rtc_handle_intr);
+}
@@ -0,0 +1,241 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: serial.c - Driver for the 16550 UART on COM1
+// --------------------------------------------------------------------------------------
+
+#include <kernel.h>
+
+// Bytes are queued in a ring and sent from the interrupt handler whenever
+// the transmit FIFO runs empty. When the ring is full, a thread waits until
+// the handler has sent half of it, so that long dumps are paced by the line
+// instead of being cut. Interrupt handlers and code running with interrupts
+// disabled can't wait, so the bytes which don't fit are dropped and counted.
+// The debug output is copied here with SERIAL_DEBUG, see kernel/debug.c.
+
+#ifndef SERIAL_BAUD
+#define SERIAL_BAUD 115200
+#endif
+
+#ifndef SERIAL_TX_BUFFER_SIZE
+#define SERIAL_TX_BUFFER_SIZE 16384
+#endif
+
+enum {
+    COM1_BASE = 0x3F8,
+
+    UART_THR = 0,   // Transmit holding register
+    UART_RBR = 0,   // Receive buffer register
+    UART_DLL = 0,   // Divisor latch, low byte
+    UART_IER = 1,   // Interrupt enable register
+    UART_DLM = 1,   // Divisor latch, high byte
+    UART_IIR = 2,   // Interrupt identification register
+    UART_FCR = 2,   // FIFO control register
+    UART_LCR = 3,   // Line control register
+    UART_MCR = 4,   // Modem control register
+    UART_LSR = 5,   // Line status register
+
+    UART_IER_THRE = 0x02,
+    UART_LCR_8N1 = 0x03,
+    UART_LCR_DLAB = 0x80,
+    UART_MCR_DTR_RTS_OUT2 = 0x0B,
+    UART_MCR_LOOPBACK = 0x1E,
+    UART_LSR_DR = 0x01,
+    UART_LSR_THRE = 0x20,
+
+    // Enable and clear both FIFOs, interrupt when 14 bytes were received
+    UART_FCR_ENABLE = 0xC7,
+    UART_IIR_FIFO = 0xC0,
+
+    UART_CLOCK = 115200,
+    UART_FIFO_SIZE = 16,
+
+    // Reads of the LSR to wait for the byte sent in loopback mode, each taking
+    // around a microsecond on the ISA bus, while the byte takes 87 at 115200 baud
+    UART_PROBE_POLLS = 10000,
+
+    EFLAGS_IF = 0x200,
+};
+
+static uint8_t serial_tx_buf[SERIAL_TX_BUFFER_SIZE];
+static uint32_t serial_tx_head = 0;
+static uint32_t serial_tx_tail = 0;
+
+static uint8_t serial_present = 0;
+static uint8_t serial_fifo_size = 1;
+static uint8_t serial_ier = 0;
+
+// Set while a thread waits for room in the ring
+static uint8_t serial_tx_waiting = 0;
+
+static struct {
+    uint32_t queued;
+    uint32_t sent;
+    uint32_t dropped;
+    uint32_t interrupts;
+} serial_stats;
+
+static uint32_t
+krn_serial_pending(void)
+{
+    return (serial_tx_head + SERIAL_TX_BUFFER_SIZE - serial_tx_tail)
+        % SERIAL_TX_BUFFER_SIZE;
+}
+
+// Fill the transmit FIFO if it's empty, and keep the interrupt enabled
+// for as long as there's something left to send. Interrupts must be disabled.
+static void
+krn_serial_fill(void)
+{
+    if (inb(COM1_BASE + UART_LSR) & UART_LSR_THRE) {
+        for (int i = 0; i < serial_fifo_size && serial_tx_tail != serial_tx_head; ++i) {
+            outb(serial_tx_buf[serial_tx_tail], COM1_BASE + UART_THR);
+            serial_tx_tail = (serial_tx_tail + 1) % SERIAL_TX_BUFFER_SIZE;
+            serial_stats.sent++;
+        }
+    }
+
+    uint8_t ier = serial_tx_tail != serial_tx_head ? UART_IER_THRE : 0;
+
+    if (ier != serial_ier) {
+        serial_ier = ier;
+        outb(ier, COM1_BASE + UART_IER);
+    }
+}
+
+static void
+krn_serial_handle_intr(isr_stack_st *isr_stack _unsd)
+{
+    serial_stats.interrupts++;
+
+    // Reading the IIR acknowledges the transmit interrupt
+    (void)inb(COM1_BASE + UART_IIR);
+    krn_serial_fill();
+
+    // Waking up the writer for every FIFO would switch threads a thousand
+    // times per second
+    if (serial_tx_waiting && krn_serial_pending() <= SERIAL_TX_BUFFER_SIZE / 2) {
+        serial_tx_waiting = 0;
+        krn_thread_wakeup(serial_tx_buf);
+    }
+}
+
+// Queue bytes for sending, from any context. Waits for room in the ring if called
+// from a thread with interrupts enabled, otherwise drops the bytes which don't fit.
+// Returns the number of bytes queued.
+size_t
+krn_serial_write(const void *buf, size_t len)
+{
+    const uint8_t *bytes = buf;
+    size_t queued = 0;
+
+    if (!serial_present) {
+        return 0;
+    }
+
+    uint32_t eflags = cpu_get_eflags();
+    int can_wait = (eflags & EFLAGS_IF) && !krn_interrupt_is_active();
+
+    cpu_cli();
+
+    while (1) {
+        size_t room = SERIAL_TX_BUFFER_SIZE - 1 - krn_serial_pending();
+        size_t count = MIN(len - queued, room);
+
+        for (size_t i = 0; i < count; ++i) {
+            serial_tx_buf[serial_tx_head] = bytes[queued + i];
+            serial_tx_head = (serial_tx_head + 1) % SERIAL_TX_BUFFER_SIZE;
+        }
+
+        queued += count;
+        krn_serial_fill();
+
+        if (queued == len || !can_wait) {
+            break;
+        }
+
+        serial_tx_waiting = 1;
+        krn_thread_wait(serial_tx_buf);
+    }
+
+    serial_stats.queued += queued;
+    serial_stats.dropped += len - queued;
+
+    cpu_set_eflags(eflags);
+
+    return queued;
+}
+
+// Send everything still queued by polling, for when interrupts are about
+// to be disabled for good
+void
+krn_serial_flush(void)
+{
+    if (!serial_present) {
+        return;
+    }
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    while (serial_tx_tail != serial_tx_head) {
+        krn_serial_fill();
+    }
+
+    cpu_set_eflags(eflags);
+}
+
+void
+krn_serial_dump_stats(void)
+{
+    if (!serial_present) {
+        krn_debug_printf("serial: not present\n");
+        return;
+    }
+
+    krn_debug_printf("serial: queued: %u, sent: %u, dropped: %u, interrupts: %u\n",
+        serial_stats.queued, serial_stats.sent, serial_stats.dropped,
+        serial_stats.interrupts);
+}
+
+void
+krn_serial_init(void)
+{
+    uint16_t divisor = UART_CLOCK / SERIAL_BAUD;
+
+    outb(0x00, COM1_BASE + UART_IER);
+
+    outb(UART_LCR_DLAB, COM1_BASE + UART_LCR);
+    outb((uint8_t)(divisor & 0xFF), COM1_BASE + UART_DLL);
+    outb((uint8_t)(divisor >> 8), COM1_BASE + UART_DLM);
+    outb(UART_LCR_8N1, COM1_BASE + UART_LCR);
+
+    outb(UART_FCR_ENABLE, COM1_BASE + UART_FCR);
+
+    // Check that a byte sent in loopback mode comes back, to make sure
+    // that the port exists
+    outb(UART_MCR_LOOPBACK, COM1_BASE + UART_MCR);
+    outb(0xAE, COM1_BASE + UART_THR);
+
+    for (int i = 0; !(inb(COM1_BASE + UART_LSR) & UART_LSR_DR); ++i) {
+        if (i == UART_PROBE_POLLS) {
+            return;
+        }
+    }
+
+    if (inb(COM1_BASE + UART_RBR) != 0xAE) {
+        return;
+    }
+
+    // Only the 16550A has a working FIFO, older UARTs send one byte at a time
+    if ((inb(COM1_BASE + UART_IIR) & UART_IIR_FIFO) == UART_IIR_FIFO) {
+        serial_fifo_size = UART_FIFO_SIZE;
+    }
+
+    // OUT2 connects the interrupt line of the UART to the PIC
+    outb(UART_MCR_DTR_RTS_OUT2, COM1_BASE + UART_MCR);
+
+    serial_present = 1;
+    krn_interrupt_set_handler(0x24, krn_serial_handle_intr);
+}
@@ -13,19 +13,27 @@ enum {
     PPI_PB       = 0x61, // Port B of 8255A-5 PPI
 };
 
-void
-krn_speaker_stop(void)
-{
-    uint8_t val = inb(PPI_PB);
-    outb(val & ~0x03, PPI_PB);
- }
+enum {
+    SPEAKER_QUEUE_SIZE = 64,
+};
 
-void
-krn_speaker_play(unsigned hz)
+// Notes are queued by the GUI and played from the timer interrupt
+static struct {
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    krn_note_st notes[SPEAKER_QUEUE_SIZE];
+} speaker_queue;
+
+static volatile uint8_t speaker_playing = 0;
+static uint32_t speaker_note_end = 0;
+
+static void
+krn_speaker_set_tone(unsigned hz)
 {
     // If hz is 0, turn off the speaker
     if (hz == 0) {
-        krn_speaker_stop();
+        uint8_t val = inb(PPI_PB);
+        outb(val & ~0x03, PPI_PB);
         return;
     }
 
@@ -41,3 +49,104 @@ krn_speaker_play(unsigned hz)
     uint8_t val = inb(PPI_PB);
     outb(val | 0x03, PPI_PB);
 }
+
+// Start the next queued note, or stop playing if there are none.
+// Must be called with interrupts disabled.
+static void
+krn_speaker_next_note(uint32_t start)
+{
+    if (speaker_queue.tail == speaker_queue.head) {
+        krn_speaker_set_tone(0);
+        speaker_playing = 0;
+        return;
+    }
+
+    krn_note_st note = speaker_queue.notes[speaker_queue.tail];
+    speaker_queue.tail = (speaker_queue.tail + 1) % SPEAKER_QUEUE_SIZE;
+
+    krn_speaker_set_tone(note.hz);
+    speaker_note_end = start + note.msecs;
+    speaker_playing = 1;
+}
+
+// Called from the timer interrupt handler
+void
+krn_speaker_on_tick(uint32_t msecs)
+{
+    // Notes follow each other without gaps, even if the tick came late
+    while (speaker_playing && (int32_t)(msecs - speaker_note_end) >= 0) {
+        krn_speaker_next_note(speaker_note_end);
+    }
+}
+
+// Get the time when the current note ends. Returns 0 if nothing is playing.
+int
+krn_speaker_get_deadline(uint32_t *msecs)
+{
+    *msecs = speaker_note_end;
+    return speaker_playing;
+}
+
+// Queue notes to be played in the background. Either all or none of them are queued.
+// Returns 0 on success, -1 if there isn't enough space.
+int
+krn_speaker_queue(const krn_note_st *notes, size_t count)
+{
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    size_t used = (speaker_queue.head + SPEAKER_QUEUE_SIZE - speaker_queue.tail) %
+        SPEAKER_QUEUE_SIZE;
+
+    if (used + count >= SPEAKER_QUEUE_SIZE) {
+        cpu_set_eflags(eflags);
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        speaker_queue.notes[speaker_queue.head] = notes[i];
+        speaker_queue.head = (speaker_queue.head + 1) % SPEAKER_QUEUE_SIZE;
+    }
+
+    if (!speaker_playing) {
+        krn_speaker_next_note(krn_timer_get_msecs());
+        krn_timer_reschedule();
+    }
+
+    cpu_set_eflags(eflags);
+    return 0;
+}
+
+// Stop playing and drop all queued notes
+void
+krn_speaker_cancel(void)
+{
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    speaker_queue.tail = speaker_queue.head;
+    speaker_playing = 0;
+    krn_speaker_set_tone(0);
+
+    cpu_set_eflags(eflags);
+}
+
+int
+krn_speaker_is_busy(void)
+{
+    return speaker_playing;
+}
+
+void
+krn_speaker_stop(void)
+{
+    krn_speaker_cancel();
+}
+
+// Play a tone until stopped, replacing any queued notes
+void
+krn_speaker_play(unsigned hz)
+{
+    krn_speaker_cancel();
+    krn_speaker_set_tone(hz);
+}
@@ -26,6 +26,19 @@ krn_system_get_cpu_vendor(void)
     return buf;
 }
 
+int
+krn_system_has_tsc(void)
+{
+    if (!cpu_has_cpuid()) {
+        return 0;
+    }
+
+    uint32_t ebx, ecx, edx;
+    cpu_cpuid(1, &ebx, &ecx, &edx);
+
+    return (edx >> 4) & 1;
+}
+
 uint32_t
 krn_system_get_total_mem(void)
 {
@@ -49,29 +62,46 @@ krn_system_get_total_mem(void)
 }
 
 uint32_t
-krn_system_get_used_mem(void)
+krn_system_get_kernel_size(void)
 {
     return (uint32_t)&krn_link_end - (uint32_t)&krn_link_start;
 }
 
 uint32_t
 krn_system_get_avail_mem(void)
+{
+    return krn_page_get_free_count() * PAGE_SIZE;
+}
+
+// Check if the kernel command line contains the given word, e.g. "benchmark"
+// when booted with "multiboot /kernel.elf benchmark"
+int
+krn_system_has_boot_arg(const char *arg)
 {
     mboot_info_st *m = krn_core_mboot_info;
-    uint32_t kernel_addr = (uint32_t)&krn_link_start;
-    uint32_t kernel_size = krn_system_get_used_mem();
 
-    if (!(m->flags & 0x40)) {
+    if (!(m->flags & 0x04) || !m->cmdline) {
         return 0;
     }
 
-    mboot_mmap_entry_st *start = m->mmap_addr;
-    mboot_mmap_entry_st *end = (mboot_mmap_entry_st *)((uint32_t)start + m->mmap_length);
+    for (const char *s = m->cmdline; *s;) {
+        size_t i = 0;
 
-    for (mboot_mmap_entry_st *e = start; e < end; ++e) {
-        if (e->type == 1 && kernel_addr >= e->addr &&
-            kernel_addr < e->addr + e->len) {
-            return (uint32_t)(e->len) - kernel_size;
+        while (s[i] && s[i] != ' ' && s[i] == arg[i]) {
+            i++;
+        }
+
+        if (!arg[i] && (!s[i] || s[i] == ' ')) {
+            return 1;
+        }
+
+        // Skip to the next word
+        while (*s && *s != ' ') {
+            s++;
+        }
+
+        while (*s == ' ') {
+            s++;
         }
     }
 
@@ -0,0 +1,549 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: thread.c - Kernel threads and the scheduler
+// --------------------------------------------------------------------------------------
+
+#include <kernel.h>
+
+// Threads are only switched on the way out of interrupt handlers. Every interrupt
+// saves the registers of the interrupted thread on its own stack, so switching
+// means returning through the saved registers of another thread instead, see
+// kernel/core_a.s. A thread gives up the CPU by raising THREAD_YIELD_INT, and is
+// preempted when an interrupt wakes up a thread of higher priority, or by the timer
+// at the end of its time slice, if there are others of the same priority.
+//
+// The thread which booted the kernel goes on to run the GUI, at a high priority.
+// The GUI isn't reentrant, so the other threads must not call into it, and the
+// apps, whose handlers and timeouts draw into their windows, run on the GUI
+// thread too. A slow handler still delays input and presentation. The threads
+// of lower priority only do kernel work, like writing the dumps of the profiler
+// and the tracers, or waiting for the serial port. When no thread is ready,
+// the idle thread halts the CPU, and its CPU time is the idle time.
+
+#ifndef THREAD_SLICE_MSECS
+#define THREAD_SLICE_MSECS 20
+#endif
+
+enum {
+    THREADS_MAX = 8,
+    THREAD_STACK_PAGES = 4,
+    THREAD_YIELD_INT = 0x30,
+
+    // Registers a new thread starts with, interrupts enabled
+    THREAD_CS = 0x08,
+    THREAD_EFLAGS = 0x202,
+};
+
+enum {
+    THREAD_FREE = 0,
+    THREAD_READY = 1,   // Including the running one
+    THREAD_BLOCKED = 2,
+    THREAD_DEAD = 3,    // Exited, its stack is reused by the next thread
+};
+
+typedef struct {
+    const char *name;
+    uint8_t state;
+    uint8_t priority;
+
+    // Registers saved when the thread was switched out
+    isr_stack_st *isr_stack;
+
+    uint32_t stack_start;
+    uint32_t stack_end;
+
+    // What a blocked thread waits for, a channel passed to krn_thread_wakeup,
+    // and/or the time to wake up at
+    const void *channel;
+    uint32_t wake_msecs;
+    uint8_t wake_set;
+
+    // CPU time, in total and as of the last sample
+    uint64_t cycles;
+    uint64_t cycles_sampled;
+    uint8_t usage;
+} thread_st;
+
+static thread_st krn_threads[THREADS_MAX];
+
+static thread_st *thread_current = NULL;
+static thread_st *thread_idle = NULL;
+
+// Set when another thread may have to run, checked on the way out of interrupts
+static volatile uint8_t thread_resched = 0;
+
+static uint32_t thread_slice_end = 0;
+static uint64_t thread_switched_at = 0;
+static uint64_t thread_sampled_at = 0;
+
+// Add the time since the last switch to the CPU time of the current thread.
+// Must be called with interrupts disabled.
+static void
+krn_thread_account(void)
+{
+    uint64_t now = krn_timer_get_cycles();
+
+    thread_current->cycles += now - thread_switched_at;
+    thread_switched_at = now;
+}
+
+static void
+krn_thread_make_ready(thread_st *thread)
+{
+    thread->state = THREAD_READY;
+    thread->channel = NULL;
+    thread->wake_set = 0;
+
+    // A blocked thread halts in krn_thread_block, waiting for any thread to run
+    if (thread->priority > thread_current->priority ||
+        thread_current->state != THREAD_READY) {
+
+        thread_resched = 1;
+    }
+}
+
+// Pick the highest priority thread which is ready, taking turns with the other
+// threads of the same priority by starting after the current one
+static thread_st *
+krn_thread_pick(void)
+{
+    thread_st *ret = NULL;
+    size_t current = thread_current - krn_threads;
+
+    for (size_t i = 1; i <= THREADS_MAX; ++i) {
+        thread_st *thread = &krn_threads[(current + i) % THREADS_MAX];
+
+        if (thread->state == THREAD_READY && (!ret || thread->priority > ret->priority)) {
+            ret = thread;
+        }
+    }
+
+    return ret;
+}
+
+// Check whether the current thread has to share the CPU with another thread
+static int
+krn_thread_has_peers(void)
+{
+    for (size_t i = 0; i < THREADS_MAX; ++i) {
+        thread_st *thread = &krn_threads[i];
+
+        if (thread != thread_current && thread->state == THREAD_READY &&
+            thread->priority == thread_current->priority) {
+
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Called on the way out of every interrupt handler, with the registers of the
+// interrupted thread. Returns the registers to restore, of another thread if it's
+// time to switch.
+isr_stack_st *
+krn_thread_schedule(isr_stack_st *isr_stack)
+{
+    if (!thread_resched || !thread_current) {
+        return isr_stack;
+    }
+
+    thread_resched = 0;
+    thread_slice_end = krn_timer_get_msecs() + THREAD_SLICE_MSECS;
+
+    thread_st *next = krn_thread_pick();
+
+    // Without the idle thread, a blocked thread may be the only one left, and
+    // halts in krn_thread_block until it's ready again
+    if (!next || next == thread_current) {
+        return isr_stack;
+    }
+
+    krn_thread_account();
+    thread_current->isr_stack = isr_stack;
+    thread_current = next;
+
+    return next->isr_stack;
+}
+
+static void
+krn_thread_handle_yield(isr_stack_st *isr_stack _unsd)
+{
+    thread_resched = 1;
+}
+
+// Give up the CPU to the other threads of the same priority, or to any other
+// thread if the current one is no longer ready
+void
+krn_thread_yield(void)
+{
+    __asm__ volatile ("int %0" : : "i" (THREAD_YIELD_INT) : "memory");
+}
+
+// Give up the CPU after the current thread stopped being ready. Without the idle
+// thread, the scheduler comes right back if nothing else is ready, so halt until
+// an interrupt makes this thread ready, or switches to another one. Must be called
+// with interrupts disabled.
+static void
+krn_thread_block(void)
+{
+    krn_thread_yield();
+
+    while (thread_current->state != THREAD_READY) {
+        cpu_sti_hlt();
+        cpu_cli();
+    }
+}
+
+// Switch right away if a thread of higher priority became ready, unless inside
+// of an interrupt handler, which switches on its way out anyway. In tickless mode,
+// a thread of the same priority needs a timer interrupt at the end of the slice.
+// Inside of the timer interrupt handler, krn_timer_reschedule leaves that to
+// the handler, which reprograms the timer last.
+static void
+krn_thread_preempt(void)
+{
+    if (krn_thread_has_peers()) {
+        krn_timer_reschedule();
+    }
+
+    if (thread_resched && !krn_interrupt_is_active()) {
+        krn_thread_yield();
+    }
+}
+
+// Called from the timer interrupt handler
+void
+krn_thread_on_tick(uint32_t msecs)
+{
+    if (!thread_current) {
+        return;
+    }
+
+    for (size_t i = 0; i < THREADS_MAX; ++i) {
+        thread_st *thread = &krn_threads[i];
+
+        if (thread->state == THREAD_BLOCKED && thread->wake_set &&
+            (int32_t)(msecs - thread->wake_msecs) >= 0) {
+
+            krn_thread_make_ready(thread);
+        }
+    }
+
+    if ((int32_t)(msecs - thread_slice_end) >= 0) {
+        thread_resched = 1;
+    }
+}
+
+// Get the time of the next timer tick needed by the threads, the earliest time
+// to wake up a sleeping thread, or the end of the time slice. Returns 0 if none.
+int
+krn_thread_get_deadline(uint32_t *msecs)
+{
+    int ret = 0;
+
+    if (!thread_current) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < THREADS_MAX; ++i) {
+        thread_st *thread = &krn_threads[i];
+
+        if (thread->state == THREAD_BLOCKED && thread->wake_set &&
+            (!ret || (int32_t)(thread->wake_msecs - *msecs) < 0)) {
+
+            *msecs = thread->wake_msecs;
+            ret = 1;
+        }
+    }
+
+    if (krn_thread_has_peers() && (!ret || (int32_t)(thread_slice_end - *msecs) < 0)) {
+        *msecs = thread_slice_end;
+        ret = 1;
+    }
+
+    return ret;
+}
+
+// Block the current thread until krn_thread_wakeup is called with the same channel.
+// Must be called with interrupts disabled, after checking the condition waited for,
+// so that a wakeup can't get lost in between. Returns with interrupts disabled.
+void
+krn_thread_wait(const void *channel)
+{
+    // Before the threads are set up, just halt until the next interrupt
+    if (!thread_current) {
+        cpu_sti_hlt();
+        cpu_cli();
+        return;
+    }
+
+    thread_current->channel = channel;
+    thread_current->state = THREAD_BLOCKED;
+    krn_thread_block();
+}
+
+// Wake up all threads waiting for the channel, from any context
+void
+krn_thread_wakeup(const void *channel)
+{
+    int woken = 0;
+
+    if (!thread_current) {
+        return;
+    }
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    for (size_t i = 0; i < THREADS_MAX; ++i) {
+        thread_st *thread = &krn_threads[i];
+
+        if (thread->state == THREAD_BLOCKED && thread->channel == channel) {
+            krn_thread_make_ready(thread);
+            woken = 1;
+        }
+    }
+
+    if (woken) {
+        krn_thread_preempt();
+    }
+
+    cpu_set_eflags(eflags);
+}
+
+// Block the current thread for at least the given time
+void
+krn_thread_sleep(uint32_t msecs)
+{
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    thread_current->wake_msecs = krn_timer_get_msecs() + msecs;
+    thread_current->wake_set = 1;
+    thread_current->state = THREAD_BLOCKED;
+
+    krn_timer_reschedule();
+    krn_thread_block();
+
+    cpu_set_eflags(eflags);
+}
+
+// Entered when the function of a thread returns
+__attribute__((noreturn)) static void
+krn_thread_exit(void)
+{
+    cpu_cli();
+
+    thread_current->state = THREAD_DEAD;
+    krn_thread_block();
+
+    while (1);
+}
+
+// Start a thread running fn(arg). Returns 0 on success, -1 if there are no free
+// slots or no memory for the stack.
+int
+krn_thread_create(const char *name, uint8_t priority, thread_fn fn, void *arg)
+{
+    thread_st *thread = NULL;
+    int ret = -1;
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    for (size_t i = 0; i < THREADS_MAX && !thread; ++i) {
+        if (krn_threads[i].state == THREAD_FREE || krn_threads[i].state == THREAD_DEAD) {
+            thread = &krn_threads[i];
+        }
+    }
+
+    // Stacks stay allocated with their slots, so they're only allocated once
+    if (thread && !thread->stack_start) {
+        uint8_t *stack = krn_page_alloc(THREAD_STACK_PAGES);
+
+        if (stack) {
+            thread->stack_start = (uint32_t)stack;
+            thread->stack_end = (uint32_t)stack + THREAD_STACK_PAGES * PAGE_SIZE;
+        }
+    }
+
+    if (thread && thread->stack_start) {
+        // The thread starts by returning from an interrupt into fn, as if it was
+        // called with arg and with krn_thread_exit as the return address. Arg is
+        // aligned to 16 bytes, as expected from the caller of a function.
+        uint32_t *top = (uint32_t *)(thread->stack_end - 16);
+
+        top[0] = (uint32_t)arg;
+        top[-1] = (uint32_t)krn_thread_exit;
+
+        thread->isr_stack = (isr_stack_st *)&top[-1] - 1;
+        *thread->isr_stack = (isr_stack_st) {
+            .eip = (uint32_t)fn,
+            .cs = THREAD_CS,
+            .eflags = THREAD_EFLAGS,
+        };
+
+        thread->name = name;
+        thread->priority = priority;
+        thread->channel = NULL;
+        thread->wake_set = 0;
+        thread->cycles = 0;
+        thread->cycles_sampled = 0;
+        thread->usage = 0;
+
+        krn_thread_make_ready(thread);
+        ret = 0;
+    }
+
+    krn_thread_preempt();
+
+    cpu_set_eflags(eflags);
+
+    return ret;
+}
+
+// Get the bounds of the stack of the current thread
+void
+krn_thread_get_stack(uint32_t *start, uint32_t *end)
+{
+    if (!thread_current) {
+        *start = (uint32_t)&krn_core_stack;
+        *end = (uint32_t)&krn_core_stack_end;
+        return;
+    }
+
+    *start = thread_current->stack_start;
+    *end = thread_current->stack_end;
+}
+
+// Get the CPU time of the idle thread, including the time since the last switch
+// if it's running
+uint64_t
+krn_thread_get_idle_cycles(void)
+{
+    if (!thread_idle) {
+        return 0;
+    }
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    uint64_t ret = thread_idle->cycles;
+
+    if (thread_current == thread_idle) {
+        ret += krn_timer_get_cycles() - thread_switched_at;
+    }
+
+    cpu_set_eflags(eflags);
+
+    return ret;
+}
+
+// Update the share of the CPU used by every thread since the previous call
+void
+krn_thread_sample_usage(void)
+{
+    if (!thread_current) {
+        return;
+    }
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    krn_thread_account();
+
+    uint64_t total = thread_switched_at - thread_sampled_at;
+    thread_sampled_at = thread_switched_at;
+
+    // Scale down so that 32-bit arithmetic is enough
+    int shift = 0;
+
+    while (total >> (24 + shift)) {
+        shift++;
+    }
+
+    for (size_t i = 0; i < THREADS_MAX; ++i) {
+        thread_st *thread = &krn_threads[i];
+        uint32_t used = (uint32_t)((thread->cycles - thread->cycles_sampled) >> shift);
+
+        thread->usage = total ? MIN(used * 100 / (uint32_t)(total >> shift), 100u) : 0;
+        thread->cycles_sampled = thread->cycles;
+    }
+
+    cpu_set_eflags(eflags);
+}
+
+// Get the usage of the idx-th thread, as of the last sample. Returns 0 if there
+// is no such thread.
+int
+krn_thread_get_usage(size_t idx, krn_thread_usage_st *usage)
+{
+    for (size_t i = 0; i < THREADS_MAX; ++i) {
+        thread_st *thread = &krn_threads[i];
+
+        if (thread->state == THREAD_FREE || thread->state == THREAD_DEAD) {
+            continue;
+        }
+
+        if (idx-- > 0) {
+            continue;
+        }
+
+        uint64_t usecs = krn_timer_cycles_to_usecs(thread->cycles_sampled);
+
+        usage->name = thread->name;
+        usage->priority = thread->priority;
+        usage->usage = thread->usage;
+
+        // Divide by 1000 by multiplying with 2^32 / 1000 in 32.32 fixed point,
+        // without 64-bit division
+        usage->msecs = (uint32_t)(((usecs >> 32) * 4294967) +
+            (((usecs & 0xFFFFFFFF) * 4294967) >> 32));
+
+        return 1;
+    }
+
+    return 0;
+}
+
+static void
+krn_thread_idle_main(void *unused _unsd)
+{
+    // Any interrupt which makes another thread ready switches to it on its way out
+    while (1) {
+        cpu_hlt();
+    }
+}
+
+// Turn the code running since boot into the first thread, and start the idle thread
+void
+krn_thread_init(const char *name, uint8_t priority)
+{
+    thread_st *thread = &krn_threads[0];
+
+    thread->name = name;
+    thread->priority = priority;
+    thread->state = THREAD_READY;
+    thread->stack_start = (uint32_t)&krn_core_stack;
+    thread->stack_end = (uint32_t)&krn_core_stack_end;
+
+    thread_switched_at = krn_timer_get_cycles();
+    thread_sampled_at = thread_switched_at;
+    thread_slice_end = krn_timer_get_msecs() + THREAD_SLICE_MSECS;
+
+    krn_interrupt_set_handler(THREAD_YIELD_INT, krn_thread_handle_yield);
+
+    thread_current = thread;
+
+    if (krn_thread_create("idle", THREAD_PRIORITY_IDLE, krn_thread_idle_main,
+        NULL) != 0) {
+
+        krn_debug_printf("thread: no memory for the idle thread\n");
+        return;
+    }
+
+    thread_idle = &krn_threads[1];
+}
@@ -7,27 +7,168 @@
 
 #include <kernel.h>
 
+// In tickless mode the PIT is programmed in one-shot mode to fire at the next
+// deadline, instead of interrupting the CPU 100 times per second
+#ifndef TIMER_TICKLESS
+#define TIMER_TICKLESS 0
+#endif
+
 enum {
     PIT_CR0 = 0x40,
+    PIT_CR2 = 0x42,
     PIT_CWR = 0x43,
+    PIT_FREQ = 1193182,
+    PIC1_CMD = 0x20,
+    PPI_PB = 0x61,
 };
 
-volatile uint8_t krn_timer_is_cpu_idle = 0;
+enum {
+    TIMER_HZ = 100,
+    TIMER_PERIOD = PIT_FREQ / TIMER_HZ,
+
+    // Longest one-shot count, leaving room to tell a counter that wrapped
+    // around after reaching zero from one that is still counting down
+    TIMER_ONESHOT_MAX = 0xF000,
+    TIMER_ONESHOT_MIN = 100,
+
+    TIMER_CALIBRATE_MSECS = 20,
+};
+
+// Factor converting PIT cycles to microseconds, in 32.32 fixed point
+#define TIMER_PIT_USECS_MULT 3599591090U
+
+// Count the PIT was last loaded with
+static uint16_t timer_count = TIMER_PERIOD;
+
+// Time until the last reload of the counter, in PIT cycles and in milliseconds.
+// The fraction of a millisecond is kept in units of 1/PIT_FREQ ms.
+static volatile uint64_t timer_cycles = 0;
+static volatile uint32_t timer_msecs = 0;
+static uint32_t timer_msecs_frac = 0;
+
+static uint32_t timer_deadline = 0;
+static uint8_t timer_deadline_set = 0;
+
+// Set while the interrupt handler runs, which reprograms the timer on its way out
+static uint8_t timer_in_handler = 0;
+
+// Cycle counter used for high resolution time, either the TSC or the PIT
+static uint8_t timer_has_tsc = 0;
+static uint32_t timer_tsc_khz = 0;
+static uint32_t timer_usecs_mult = TIMER_PIT_USECS_MULT;
+
+// While profiling, the timer interrupts more often, but the GUI still gets
+// ticks at the usual rate, one per every timer_sample_ratio interrupts
+static uint32_t timer_sample_period = 0;
+static uint32_t timer_sample_ratio = 1;
+static uint32_t timer_sample_count = 0;
+
+static uint64_t usage_start = 0;
+static uint64_t usage_idle_start = 0;
+
+static int
+krn_timer_is_irq_pending(void)
+{
+    // Read the interrupt request register of the PIC
+    outb(0x0A, PIC1_CMD);
+    return inb(PIC1_CMD) & 0x01;
+}
+
+// Get the number of PIT cycles since the last reload of the counter.
+// Must be called with interrupts disabled.
+static uint32_t
+krn_timer_read_elapsed(void)
+{
+    // Latch counter 0 and read LSB and MSB
+    outb(0x00, PIT_CWR);
+    uint16_t count = inb(PIT_CR0);
+    count |= inb(PIT_CR0) << 8;
 
-volatile static uint32_t timer_msecs = 0;
-static uint32_t idle_ticks = 0;
-static uint32_t total_ticks = 0;
+    if (TIMER_TICKLESS) {
+        // In mode 0 the counter keeps going after reaching zero
+        if (count > timer_count) {
+            return timer_count + (0x10000 - count);
+        }
+
+        return timer_count - count;
+    }
+
+    uint32_t elapsed = timer_count - count;
+
+    // The counter was already reloaded, but the interrupt wasn't handled yet
+    if (elapsed < timer_count / 2 && krn_timer_is_irq_pending()) {
+        elapsed += timer_count;
+    }
+
+    return elapsed;
+}
 
 static void
-krn_timer_handle_intr(isr_stack_st *isr_stack __attribute__((unused)))
+krn_timer_advance(uint32_t cycles)
 {
-    timer_msecs += 10;
+    timer_cycles += cycles;
+    timer_msecs_frac += cycles * 1000;
+    timer_msecs += timer_msecs_frac / PIT_FREQ;
+    timer_msecs_frac %= PIT_FREQ;
+}
+
+// Load the counter with the number of cycles left until the deadline
+static void
+krn_timer_program_oneshot(void)
+{
+    uint32_t count = TIMER_ONESHOT_MAX;
+    uint32_t deadline = timer_deadline;
+    int deadline_set = timer_deadline_set;
+    uint32_t note_end, repeat_next, thread_next;
+
+    // The speaker needs a tick when the current note ends
+    if (krn_speaker_get_deadline(&note_end) &&
+        (!deadline_set || (int32_t)(note_end - deadline) < 0)) {
+
+        deadline = note_end;
+        deadline_set = 1;
+    }
+
+    // The keyboard needs a tick when a held key repeats
+    if (krn_keyboard_get_deadline(&repeat_next) &&
+        (!deadline_set || (int32_t)(repeat_next - deadline) < 0)) {
+
+        deadline = repeat_next;
+        deadline_set = 1;
+    }
 
-    total_ticks++;
-    if (krn_timer_is_cpu_idle) {
-        idle_ticks++;
+    // The threads need a tick to wake up from sleep or to end the time slice
+    if (krn_thread_get_deadline(&thread_next) &&
+        (!deadline_set || (int32_t)(thread_next - deadline) < 0)) {
+
+        deadline = thread_next;
+        deadline_set = 1;
     }
 
+    int32_t left = deadline - timer_msecs;
+
+    if (deadline_set && left <= 0) {
+        count = TIMER_ONESHOT_MIN;
+    } else if (deadline_set && left < TIMER_ONESHOT_MAX * 1000 / PIT_FREQ) {
+        count = (left * PIT_FREQ - timer_msecs_frac) / 1000 + 1;
+        count = MAX(count, (uint32_t)TIMER_ONESHOT_MIN);
+    }
+
+    if (timer_sample_period) {
+        count = MIN(count, timer_sample_period);
+    }
+
+    timer_count = count;
+
+    // Set Counter 0, write both LSB and MSB, use mode 0, binary counter
+    outb(0x30, PIT_CWR);
+    outb((uint8_t)((count >> 0) & 0xFF), PIT_CR0);
+    outb((uint8_t)((count >> 8) & 0xFF), PIT_CR0);
+}
+
+static void
+krn_timer_push_tick(void)
+{
     event_st event = {
         .type = EVENT_TIMER_TICK,
         .timer_msecs = timer_msecs,
@@ -36,44 +177,254 @@ krn_timer_handle_intr(isr_stack_st *isr_stack __attribute__((unused)))
     (void)krn_event_ipush(event);
 }
 
+static void
+krn_timer_handle_intr(isr_stack_st *isr_stack)
+{
+    krn_profile_on_tick(isr_stack);
+
+    if (TIMER_TICKLESS) {
+        // Account for the time that passed since reaching zero, too
+        krn_timer_advance(krn_timer_read_elapsed());
+
+        // The handlers below may wake up threads, which would reprogram the timer
+        // before the counter is reloaded, counting the elapsed time twice
+        timer_in_handler = 1;
+
+        krn_speaker_on_tick(timer_msecs);
+        krn_keyboard_on_tick(timer_msecs);
+        krn_thread_on_tick(timer_msecs);
+
+        if (timer_deadline_set && (int32_t)(timer_msecs - timer_deadline) >= 0) {
+            timer_deadline_set = 0;
+            krn_timer_push_tick();
+        }
+
+        timer_in_handler = 0;
+
+        // Last, so that it includes the deadlines of the threads woken up above
+        krn_timer_program_oneshot();
+    } else {
+        krn_timer_advance(timer_count);
+        krn_speaker_on_tick(timer_msecs);
+        krn_keyboard_on_tick(timer_msecs);
+        krn_thread_on_tick(timer_msecs);
+
+        if (++timer_sample_count >= timer_sample_ratio) {
+            timer_sample_count = 0;
+            krn_timer_push_tick();
+        }
+    }
+}
+
+// Get the value of a monotonic cycle counter, the TSC if the CPU has it,
+// otherwise the number of PIT cycles since boot
+uint64_t
+krn_timer_get_cycles(void)
+{
+    if (timer_has_tsc) {
+        return cpu_rdtsc();
+    }
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    uint64_t ret = timer_cycles + krn_timer_read_elapsed();
+
+    cpu_set_eflags(eflags);
+    return ret;
+}
+
+uint64_t
+krn_timer_cycles_to_usecs(uint64_t cycles)
+{
+    // Multiply by the 32.32 factor without 64-bit division
+    uint64_t lo = (uint64_t)(uint32_t)cycles * timer_usecs_mult;
+    uint64_t hi = (uint64_t)(uint32_t)(cycles >> 32) * timer_usecs_mult;
+
+    return hi + (lo >> 32);
+}
+
+uint64_t
+krn_timer_get_usecs(void)
+{
+    return krn_timer_cycles_to_usecs(krn_timer_get_cycles());
+}
+
 uint32_t
 krn_timer_get_msecs(void)
 {
-    return timer_msecs;
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    uint32_t ret = timer_msecs +
+        (timer_msecs_frac + krn_timer_read_elapsed() * 1000) / PIT_FREQ;
+
+    cpu_set_eflags(eflags);
+    return ret;
+}
+
+// Request a timer tick event at the given time. In tickless mode,
+// the CPU is otherwise only woken up once in a while.
+void
+krn_timer_set_deadline(uint32_t msecs)
+{
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    timer_deadline = msecs;
+    timer_deadline_set = 1;
+    krn_timer_reschedule();
+
+    cpu_set_eflags(eflags);
+}
+
+// Reprogram the timer after one of the deadlines changed
+void
+krn_timer_reschedule(void)
+{
+    if (!TIMER_TICKLESS || timer_in_handler) {
+        return;
+    }
+
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    krn_timer_advance(krn_timer_read_elapsed());
+    krn_timer_program_oneshot();
+
+    cpu_set_eflags(eflags);
+}
+
+// Interrupt hz times per second for sampling, or go back to the usual rate if hz is 0
+void
+krn_timer_set_sample_rate(unsigned hz)
+{
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    timer_sample_period = hz ? PIT_FREQ / hz : 0;
+
+    if (TIMER_TICKLESS) {
+        krn_timer_advance(krn_timer_read_elapsed());
+        krn_timer_program_oneshot();
+    } else {
+        uint32_t period = hz ? timer_sample_period : (uint32_t)TIMER_PERIOD;
+
+        // Writing the control word restarts the counter, so account for
+        // the part of the period that already passed
+        krn_timer_advance(krn_timer_read_elapsed());
+        timer_count = period;
+        timer_sample_ratio = hz ? MAX(hz / TIMER_HZ, 1u) : 1;
+        timer_sample_count = 0;
+
+        // Set Counter 0, write both LSB and MSB, use mode 2, binary counter
+        outb(0x34, PIT_CWR);
+        outb((uint8_t)((period >> 0) & 0xFF), PIT_CR0);
+        outb((uint8_t)((period >> 8) & 0xFF), PIT_CR0);
+    }
+
+    cpu_set_eflags(eflags);
+}
+
+// Get the total time spent in the idle thread since boot
+uint64_t
+krn_timer_get_idle_usecs(void)
+{
+    return krn_timer_cycles_to_usecs(krn_thread_get_idle_cycles());
 }
 
 uint8_t
 krn_timer_get_cpu_usage(void)
 {
+    uint64_t now = krn_timer_get_cycles();
+    uint64_t idle_cycles = krn_thread_get_idle_cycles();
+
+    uint64_t idle = idle_cycles - usage_idle_start;
+    uint64_t total = now - usage_start;
+    usage_idle_start = idle_cycles;
+    usage_start = now;
+
+    // Scale down so that 32-bit arithmetic is enough
+    while (total >> 24) {
+        total >>= 1;
+        idle >>= 1;
+    }
+
+    if (total == 0 || idle >= total) {
+        return 0;
+    }
+
+    return (uint8_t)(100 - (uint32_t)idle * 100 / (uint32_t)total);
+}
+
+// Measure the frequency of the TSC by letting PIT channel 2 count down
+// for a known time, with the speaker disconnected
+static void
+krn_timer_calibrate_tsc(void)
+{
+    uint32_t count = PIT_FREQ * TIMER_CALIBRATE_MSECS / 1000;
+    uint8_t ppi = inb(PPI_PB);
+
     uint32_t eflags = cpu_get_eflags();
     cpu_cli();
 
-    uint32_t idle = idle_ticks;
-    uint32_t total = total_ticks;
-    idle_ticks = 0;
-    total_ticks = 0;
+    // Enable the gate of channel 2, disable the speaker
+    outb((ppi & ~0x02) | 0x01, PPI_PB);
+
+    // Set Counter 2, write both LSB and MSB, use mode 0, binary counter
+    outb(0xB0, PIT_CWR);
+    outb((uint8_t)((count >> 0) & 0xFF), PIT_CR2);
+    outb((uint8_t)((count >> 8) & 0xFF), PIT_CR2);
+
+    uint64_t start = cpu_rdtsc();
+
+    // Wait for the output of channel 2 to go high
+    while (!(inb(PPI_PB) & 0x20));
 
+    uint64_t end = cpu_rdtsc();
+
+    outb(ppi, PPI_PB);
     cpu_set_eflags(eflags);
 
-    if (total == 0) {
-        return 0;
+    timer_tsc_khz = (uint32_t)(end - start) / TIMER_CALIBRATE_MSECS;
+
+    if (timer_tsc_khz <= 1000) {
+        return;
     }
 
-    return (uint8_t)(100 - (idle * 100 / total));
+    // 2^32 * 1000 / khz, the quotient fits in 32 bits since khz > 1000
+    uint32_t mult, rem;
+    __asm__ ("divl %4"
+        : "=a" (mult), "=d" (rem)
+        : "a" (0), "d" (1000), "rm" (timer_tsc_khz));
+
+    timer_usecs_mult = mult;
+    timer_has_tsc = 1;
 }
 
 void
 krn_timer_init(void)
 {
-    uint8_t hz = 100;
-    uint32_t div = 1193180 / hz;
+    if (krn_system_has_tsc()) {
+        krn_timer_calibrate_tsc();
+    }
+
+    if (timer_has_tsc) {
+        krn_debug_printf("timer: using TSC at %u kHz\n", timer_tsc_khz);
+    } else {
+        krn_debug_printf("timer: using PIT readback\n");
+    }
 
-    // Set Counter 0, write both LSB and MSB, use mode 3, binary counter
-    outb(0x36, PIT_CWR);
+    if (TIMER_TICKLESS) {
+        krn_timer_program_oneshot();
+    } else {
+        // Set Counter 0, write both LSB and MSB, use mode 2, binary counter
+        outb(0x34, PIT_CWR);
 
-    // Write LSB and MSB for counter 0
-    outb((uint8_t)((div >> 0) & 0xFF), PIT_CR0);
-    outb((uint8_t)((div >> 8) & 0xFF), PIT_CR0);
+        // Write LSB and MSB for counter 0
+        outb((uint8_t)((TIMER_PERIOD >> 0) & 0xFF), PIT_CR0);
+        outb((uint8_t)((TIMER_PERIOD >> 8) & 0xFF), PIT_CR0);
+    }
 
     krn_interrupt_set_handler(0x20, krn_timer_handle_intr);
 }
@@ -0,0 +1,227 @@
+// --------------------------------------------------------------------------------------
+// Copyright (c) 2026 luke8086
+// Distributed under the terms of GPL-2 License
+// --------------------------------------------------------------------------------------
+// File: trace.c - Tracing of function calls and of binary trace events
+// --------------------------------------------------------------------------------------
+
+#include <kernel.h>
+
+// Building with "make TRACE_FUNCS=1" compiles the GUI and the apps with
+// -finstrument-functions, so that every function calls the hooks below on entry
+// and on exit. Tracing starts with Ctrl+Alt+T and stops when pressed again or
+// when the buffer is full. The records are then dumped to the debug port once
+// the CPU goes idle, see misc/trace.py.
+
+#ifndef TRACE_FUNCS
+#define TRACE_FUNCS 0
+#endif
+
+#if TRACE_FUNCS
+
+enum {
+    TRACE_RECORDS_MAX = 65536,
+};
+
+// Kernel addresses are below 2GB, so the top bit is free
+#define TRACE_FLAG_EXIT 0x80000000U
+
+typedef struct {
+    uint32_t addr;
+    uint32_t cycles;
+} trace_record_st;
+
+static trace_record_st trace_records[TRACE_RECORDS_MAX];
+static uint32_t trace_count = 0;
+
+static volatile uint8_t trace_active = 0;
+static volatile uint8_t trace_pending = 0;
+
+__attribute__((no_instrument_function)) static inline void
+krn_trace_record(void *fn, uint32_t flags)
+{
+    if (!trace_active) {
+        return;
+    }
+
+    if (trace_count == TRACE_RECORDS_MAX) {
+        trace_active = 0;
+        trace_pending = 1;
+        krn_debug_dump_wakeup();
+        return;
+    }
+
+    trace_records[trace_count].addr = (uint32_t)fn | flags;
+    trace_records[trace_count].cycles = (uint32_t)krn_timer_get_cycles();
+    trace_count++;
+}
+
+__attribute__((no_instrument_function)) void
+__cyg_profile_func_enter(void *fn, void *call_site _unsd)
+{
+    krn_trace_record(fn, 0);
+}
+
+__attribute__((no_instrument_function)) void
+__cyg_profile_func_exit(void *fn, void *call_site _unsd)
+{
+    krn_trace_record(fn, TRACE_FLAG_EXIT);
+}
+
+// Called from the keyboard interrupt handler on Ctrl+Alt+T
+void
+krn_trace_toggle(void)
+{
+    if (trace_active) {
+        trace_active = 0;
+        trace_pending = 1;
+        krn_debug_beep(1500, 50, 2);
+        krn_debug_dump_wakeup();
+    } else if (!trace_pending) {
+        trace_count = 0;
+        trace_active = 1;
+        krn_debug_beep(1500, 50, 1);
+    }
+}
+
+// Dump the records of the last run, if it wasn't dumped yet. Timestamps are
+// the low 32 bits of the cycle counter, converted to microseconds by
+// multiplying with usecs_mult and dividing by 2^32.
+void
+krn_trace_dump(void)
+{
+    if (!trace_pending) {
+        return;
+    }
+
+    // Converting 2^32 cycles yields the factor itself
+    uint32_t usecs_mult = (uint32_t)krn_timer_cycles_to_usecs(1ULL << 32);
+
+    krn_debug_printf("trace: begin records=%u usecs_mult=%u\n", trace_count, usecs_mult);
+
+    for (uint32_t i = 0; i < trace_count; ++i) {
+        krn_debug_printf("trace: %08x %08x\n", trace_records[i].addr,
+            trace_records[i].cycles);
+    }
+
+    krn_debug_printf("trace: end\n");
+
+    trace_pending = 0;
+}
+
+#else
+
+void
+krn_trace_toggle(void)
+{
+    krn_debug_printf("trace: not available, build with make TRACE_FUNCS=1\n");
+}
+
+void
+krn_trace_dump(void)
+{
+}
+
+#endif
+
+// Events recorded with KRN_TRACE when TRACE_EVENTS is set in config.h. Unlike
+// krn_debug_printf, recording an event only stores an id, a timestamp and three
+// arguments in a ring, so it's cheap enough for interrupt handlers and doesn't
+// distort the timing being measured. The ring is drained to the debug port once
+// the CPU goes idle, in binary frames which misc/trace-events.py turns back into
+// readable lines.
+
+#if TRACE_EVENTS
+
+enum {
+    TRACE_EVENTS_MAX = 1024,
+};
+
+typedef struct {
+    uint32_t usecs;
+    uint16_t id;
+    uint16_t seq;
+    uint32_t args[3];
+} __attribute__((packed)) trace_event_st;
+
+static trace_event_st trace_events[TRACE_EVENTS_MAX];
+
+// Head is advanced by the writers once a slot is filled and tail by the drain.
+// Both only grow, the slot of a position is its remainder of TRACE_EVENTS_MAX.
+static volatile uint32_t trace_events_head = 0;
+static volatile uint32_t trace_events_tail = 0;
+
+// Incremented for every event, including the ones dropped when the ring is full,
+// so that drops show up as gaps in the sequence numbers
+static uint32_t trace_events_seq = 0;
+
+// Record an event, from any context. Writers race with interrupt handlers and,
+// since threads are preempted, with each other, so the slot is filled with
+// interrupts disabled, and only published to the drain afterwards.
+void
+krn_trace_event(uint16_t id, uint32_t arg0, uint32_t arg1, uint32_t arg2)
+{
+    uint32_t eflags = cpu_get_eflags();
+    cpu_cli();
+
+    uint32_t seq = trace_events_seq++;
+    uint32_t head = trace_events_head;
+
+    if (head - trace_events_tail >= TRACE_EVENTS_MAX) {
+        cpu_set_eflags(eflags);
+        return;
+    }
+
+    trace_event_st *event = &trace_events[head % TRACE_EVENTS_MAX];
+
+    event->usecs = (uint32_t)krn_timer_get_usecs();
+    event->id = id;
+    event->seq = (uint16_t)seq;
+    event->args[0] = arg0;
+    event->args[1] = arg1;
+    event->args[2] = arg2;
+
+    cpu_barrier();
+    trace_events_head = head + 1;
+
+    cpu_set_eflags(eflags);
+
+    krn_debug_dump_wakeup();
+}
+
+// Write the recorded events to the debug port, each one preceded by a zero byte
+// and a 'T', which never appear in the text written by krn_debug_printf. Every
+// frame is written at once, so that the output of other threads can't end up
+// in the middle of it.
+void
+krn_trace_drain(void)
+{
+    uint8_t frame[2 + sizeof(trace_event_st)] = { 0, 'T' };
+    uint32_t head = trace_events_head;
+
+    cpu_barrier();
+
+    while (trace_events_tail != head) {
+        memcpy(frame + 2, &trace_events[trace_events_tail % TRACE_EVENTS_MAX],
+            sizeof(trace_event_st));
+        krn_debug_write(frame, sizeof(frame));
+
+        cpu_barrier();
+        trace_events_tail++;
+    }
+}
+
+#else
+
+void
+krn_trace_event(uint16_t id _unsd, uint32_t arg0 _unsd, uint32_t arg1 _unsd,
+    uint32_t arg2 _unsd)
+{
+}
+
+void
+krn_trace_drain(void)
+{
+}
+
+#endif
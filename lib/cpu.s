@@ -7,72 +7,13 @@
 
 [cpu 386]
 
-global cpu_get_eflags:function
-cpu_get_eflags:
-    pushfd
-    pop eax
-    ret
+[section .bss]
 
-global cpu_set_eflags:function
-cpu_set_eflags:
-    mov eax, [esp + 4]
-    push eax
-    popfd
-    ret
-
-global cpu_cli:function
-cpu_cli:
-    cli
-    ret
+global cpu_io_count:data
+cpu_io_count:
+    resd 1
 
-global cpu_hlt:function
-cpu_hlt:
-    hlt
-    ret
-
-global inb:function
-inb:
-    push ebp
-    mov ebp, esp
-
-    push edx
-    mov dx, [ebp + 8]
-    in al, dx
-    pop edx
-
-    mov esp, ebp
-    pop ebp
-    ret
-
-global outb:function
-outb:
-    push ebp
-    mov ebp, esp
-    pusha
-
-    mov dx, [ebp + 12]
-    mov al, [ebp + 8]
-    out dx, al
-
-    popa
-    mov esp, ebp
-    pop ebp
-    ret
-
-global outw:function
-outw:
-    push ebp
-    mov ebp, esp
-    pusha
-
-    mov dx, [ebp + 12]
-    mov ax, [ebp + 8]
-    out dx, ax
-
-    popa
-    mov esp, ebp
-    pop ebp
-    ret
+[section .text]
 
 global cpu_has_cpuid:function
 cpu_has_cpuid:
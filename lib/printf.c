@@ -454,7 +454,7 @@ pf_vasnprintf(char *buf, size_t nbyte, const char *fmt,
 
     // The return value is the amount of characters which would
     // be emitted, given enough space, or -1 on error
-    return c->error ? -1 : (p->i - 1);
+    return c->error ? -1 : (int)(p->i - 1);
 }
 
 int
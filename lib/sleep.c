@@ -14,6 +14,7 @@ sleep(uint32_t msecs)
     uint32_t start = krn_timer_get_msecs();
 
     while (krn_timer_get_msecs() - start < msecs) {
+        krn_timer_set_deadline(start + msecs);
         cpu_hlt();
     }
 }
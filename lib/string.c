@@ -33,6 +33,26 @@ memcpy(void *dest, const void *src, size_t n)
     return dest;
 }
 
+// Copying forward is safe when moving to lower addresses,
+// otherwise copy backwards
+void *
+memmove(void *dest, const void *src, size_t n)
+{
+    uint8_t *srcb = (uint8_t *)src;
+    uint8_t *destb = (uint8_t *)dest;
+
+    if (destb <= srcb || destb >= srcb + n) {
+        return memcpy(dest, src, n);
+    }
+
+    while (n > 0) {
+        --n;
+        destb[n] = srcb[n];
+    }
+
+    return dest;
+}
+
 void *
 memset(void *dest, int c, size_t n)
 {
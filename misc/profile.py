@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+
+# Symbolize the samples of the profiler in kernel/profile.c, as dumped to the debug
+# port, and print a flat profile and a call graph. Usage:
+#
+#   qemu-system-i386 ... -debugcon file:debug.log
+#   misc/profile.py debug.log [build/kernel.elf] [--folded]
+#
+# With --folded, the stacks are printed in the format of flamegraph.pl instead.
+
+import bisect
+import collections
+import subprocess
+import sys
+
+def load_symbols(elf):
+    out = subprocess.run(["nm", "-n", "--defined-only", elf],
+        check=True, capture_output=True, text=True).stdout
+
+    addrs = []
+    names = []
+
+    for line in out.splitlines():
+        cols = line.split()
+
+        if len(cols) != 3 or cols[1] not in "tT":
+            continue
+
+        addrs.append(int(cols[0], 16))
+        names.append(cols[2])
+
+    return addrs, names
+
+def load_samples(path):
+    runs = []
+    samples = None
+
+    for line in open(path, "r", errors="replace"):
+        if line.startswith("profile: begin"):
+            print(line.strip(), file=sys.stderr)
+            samples = []
+        elif line.startswith("profile: s ") and samples is not None:
+            samples.append([int(x, 16) for x in line.split()[2:]])
+        elif line.startswith("profile: end") and samples is not None:
+            runs.append(samples)
+            samples = None
+
+    if not runs:
+        raise SystemExit(f"No complete profile found in {path}")
+
+    # Only the last run is reported
+    return runs[-1]
+
+def symbolize(samples, symbols):
+    addrs, names = symbols
+    ret = []
+
+    def lookup(addr):
+        idx = bisect.bisect_right(addrs, addr) - 1
+        return names[idx] if idx >= 0 else f"0x{addr:08x}"
+
+    for sample in samples:
+        # Return addresses point past the call, so look up the call itself
+        ret.append([lookup(sample[0])] + [lookup(x - 1) for x in sample[1:]])
+
+    return ret
+
+def print_flat(stacks):
+    total = len(stacks)
+    self_counts = collections.Counter(s[0] for s in stacks)
+    incl_counts = collections.Counter(f for s in stacks for f in set(s))
+
+    print(f"Flat profile, {total} samples\n")
+    print("  self%    self  incl%    incl  function")
+
+    for name, count in self_counts.most_common():
+        incl = incl_counts[name]
+        print(f"{count * 100 / total:7.2f} {count:7} {incl * 100 / total:6.2f} "
+            f"{incl:7}  {name}")
+
+def print_call_graph(stacks):
+    incl_counts = collections.Counter(f for s in stacks for f in set(s))
+    callers = collections.defaultdict(collections.Counter)
+    callees = collections.defaultdict(collections.Counter)
+
+    for s in stacks:
+        for callee, caller in set(zip(s, s[1:])):
+            callers[callee][caller] += 1
+            callees[caller][callee] += 1
+
+    if not callers:
+        print("\nNo callers were recorded, see PROFILE_CALLERS")
+        return
+
+    print("\nCall graph, callers above and callees below every function\n")
+
+    for name, incl in incl_counts.most_common():
+        for caller, count in callers[name].most_common():
+            print(f"{'':16}{count:7}  {caller}")
+
+        print(f"{incl:15}   {name}")
+
+        for callee, count in callees[name].most_common():
+            print(f"{'':16}{count:7}  {callee}")
+
+        print()
+
+def print_folded(stacks):
+    folded = collections.Counter(";".join(reversed(s)) for s in stacks)
+
+    for stack, count in folded.most_common():
+        print(f"{stack} {count}")
+
+def main():
+    args = [x for x in sys.argv[1:] if not x.startswith("--")]
+
+    if not args:
+        raise SystemExit(f"Usage: {sys.argv[0]} LOG [ELF] [--folded]")
+
+    elf = args[1] if len(args) > 1 else "build/kernel.elf"
+    stacks = symbolize(load_samples(args[0]), load_symbols(elf))
+
+    if "--folded" in sys.argv:
+        print_folded(stacks)
+    else:
+        print_flat(stacks)
+        print_call_graph(stacks)
+
+if __name__ == "__main__":
+    main()
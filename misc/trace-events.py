@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+
+# Decode the binary trace events of kernel/trace.c, as written to the debug port,
+# and print the whole log with the events turned into readable lines. Usage:
+#
+#   qemu-system-i386 ... -debugcon file:debug.log
+#   misc/trace-events.py debug.log [include/kernel.h]
+#
+# The names of the events and the formats of their arguments are taken from
+# the comments of the TRACE_EVENT_* ids in include/kernel.h.
+
+import re
+import struct
+import sys
+
+MARKER = b"\0T"
+EVENT = struct.Struct("<IHH3I")
+
+def load_formats(header):
+    formats = {}
+
+    for line in open(header):
+        m = re.match(r"\s*TRACE_EVENT_\w+ = (\d+),\s*// (.*)", line)
+
+        if m:
+            formats[int(m.group(1))] = m.group(2).strip()
+
+    return formats
+
+def format_event(formats, usecs, event_id, args):
+    fmt = formats.get(event_id)
+
+    if fmt is None:
+        text = f"unknown<{event_id}> " + " ".join(f"{x:08x}" for x in args)
+    else:
+        text = fmt % args[:fmt.count("%")]
+
+    return f"[{usecs // 1000000:5}.{usecs % 1000000:06}] {text}"
+
+def decode(data, formats):
+    pos = 0
+    seq = None
+    usecs = 0
+    prev = None
+
+    while pos < len(data):
+        start = data.find(MARKER, pos)
+
+        if start < 0 or start + len(MARKER) + EVENT.size > len(data):
+            sys.stdout.write(data[pos:].decode(errors="replace"))
+            break
+
+        sys.stdout.write(data[pos:start].decode(errors="replace"))
+        pos = start + len(MARKER) + EVENT.size
+
+        stamp, event_id, event_seq, *args = EVENT.unpack_from(data, start + len(MARKER))
+
+        # Timestamps are the low 32 bits of the microseconds since boot
+        usecs += (stamp - prev) & 0xFFFFFFFF if prev is not None else stamp
+        prev = stamp
+
+        if seq is not None and (event_seq - seq - 1) & 0xFFFF:
+            print(f"trace: dropped {(event_seq - seq - 1) & 0xFFFF} events")
+
+        seq = event_seq
+
+        print(f"trace: {format_event(formats, usecs, event_id, tuple(args))}")
+
+def main():
+    if len(sys.argv) < 2:
+        raise SystemExit(f"Usage: {sys.argv[0]} LOG [HEADER]")
+
+    header = sys.argv[2] if len(sys.argv) > 2 else "include/kernel.h"
+
+    with open(sys.argv[1], "rb") as f:
+        decode(f.read(), load_formats(header))
+
+if __name__ == "__main__":
+    main()
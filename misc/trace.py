@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+
+# Convert the function call records of kernel/trace.c, as dumped to the debug
+# port, into a Chrome trace, viewable in chrome://tracing or ui.perfetto.dev.
+# Usage:
+#
+#   make clean && make TRACE_FUNCS=1
+#   qemu-system-i386 ... -debugcon file:debug.log
+#   misc/trace.py debug.log [build/kernel.elf] [--folded] > trace.json
+#
+# With --folded, the stacks are printed in the format of flamegraph.pl instead,
+# weighted by their self time in nanoseconds.
+
+import bisect
+import collections
+import json
+import subprocess
+import sys
+
+TRACE_FLAG_EXIT = 0x80000000
+
+def load_symbols(elf):
+    out = subprocess.run(["nm", "-n", "--defined-only", elf],
+        check=True, capture_output=True, text=True).stdout
+
+    addrs = []
+    names = []
+
+    for line in out.splitlines():
+        cols = line.split()
+
+        if len(cols) == 3 and cols[1] in "tT":
+            addrs.append(int(cols[0], 16))
+            names.append(cols[2])
+
+    def lookup(addr):
+        idx = bisect.bisect_right(addrs, addr) - 1
+        return names[idx] if idx >= 0 else f"0x{addr:08x}"
+
+    return lookup
+
+def load_records(path):
+    runs = []
+    records = None
+
+    for line in open(path, "r", errors="replace"):
+        cols = line.split()
+
+        if line.startswith("trace: begin"):
+            print(line.strip(), file=sys.stderr)
+            args = dict(x.split("=") for x in cols[2:])
+            usecs_mult = int(args["usecs_mult"])
+            records = []
+        elif line.startswith("trace: end") and records is not None:
+            runs.append((usecs_mult, records))
+            records = None
+        elif line.startswith("trace: ") and records is not None and len(cols) == 3:
+            records.append((int(cols[1], 16), int(cols[2], 16)))
+
+    if not runs:
+        raise SystemExit(f"No complete trace found in {path}")
+
+    # Only the last run is converted
+    return runs[-1]
+
+# Turn the records into calls, as tuples of (stack, start, duration, self time),
+# in nanoseconds since the first record. Calls which were already in progress
+# when tracing started are skipped, the ones still in progress at the end
+# are closed with the last timestamp.
+def replay(usecs_mult, records, lookup):
+    calls = []
+    stack = []
+    cycles = 0
+    prev = records[0][1] if records else 0
+    now = 0
+
+    def close(now):
+        name, start, children = stack.pop()
+        duration = now - start
+
+        calls.append(([x[0] for x in stack] + [name], start, duration,
+            duration - children))
+
+        if stack:
+            stack[-1][2] += duration
+
+    for addr, stamp in records:
+        # Stamps are the low 32 bits of the cycle counter
+        cycles += (stamp - prev) & 0xFFFFFFFF
+        prev = stamp
+        now = cycles * usecs_mult * 1000 >> 32
+
+        name = lookup(addr & ~TRACE_FLAG_EXIT)
+
+        if not addr & TRACE_FLAG_EXIT:
+            stack.append([name, now, 0])
+            continue
+
+        if not any(x[0] == name for x in stack):
+            continue
+
+        while stack[-1][0] != name:
+            close(now)
+
+        close(now)
+
+    while stack:
+        close(now)
+
+    return calls
+
+def print_chrome(calls):
+    events = [{
+        "name": stack[-1],
+        "ph": "X",
+        "ts": start / 1000,
+        "dur": duration / 1000,
+        "pid": 1,
+        "tid": 1,
+    } for stack, start, duration, _ in calls]
+
+    json.dump({ "traceEvents": events, "displayTimeUnit": "ns" }, sys.stdout)
+    print()
+
+def print_folded(calls):
+    folded = collections.Counter()
+
+    for stack, _, _, self_time in calls:
+        folded[";".join(stack)] += self_time
+
+    for stack, nsecs in folded.most_common():
+        print(f"{stack} {nsecs}")
+
+def main():
+    args = [x for x in sys.argv[1:] if not x.startswith("--")]
+
+    if not args:
+        raise SystemExit(f"Usage: {sys.argv[0]} LOG [ELF] [--folded]")
+
+    elf = args[1] if len(args) > 1 else "build/kernel.elf"
+    usecs_mult, records = load_records(args[0])
+    calls = replay(usecs_mult, records, load_symbols(elf))
+
+    if "--folded" in sys.argv:
+        print_folded(calls)
+    else:
+        print_chrome(calls)
+
+if __name__ == "__main__":
+    main()